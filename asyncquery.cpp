@@ -0,0 +1,272 @@
+/*****************************************************************/
+/* AsyncQuery.cpp
+/*
+/* Author: Hans Nicolaus
+/*
+/* This file contains the implementations of the constructors and
+/* methods which interfaces are defined in the AsyncQuery.h file
+/*
+/*****************************************************************/
+
+#include "asyncquery.h"
+#include "perfcounters.h"
+#include <algorithm>
+#include <climits>
+#include <functional>
+#include <queue>
+
+/*
+ Default constructor:
+ Pre-condition: None.
+ Post-condition: A token that has not been cancelled. Copies share its state.
+ */
+CancellationToken::CancellationToken() : cancelled(make_shared<atomic<bool> >(false))
+{
+}
+
+/*
+ cancel:
+ Pre-condition: None.
+ Post-condition: The token and all its copies are cancelled. Any thread may call it.
+ */
+void CancellationToken::cancel()
+{
+    cancelled->store(true, memory_order_release);
+}
+
+/*
+ isCancelled:
+ Pre-condition: None.
+ Post-condition: Returns true if cancel was called on the token or one of its copies.
+ */
+bool CancellationToken::isCancelled() const
+{
+    return cancelled->load(memory_order_acquire);
+}
+
+/*
+ shortestPaths:
+ Pre-condition: graph outlives the query.
+                source is the source vertex.
+ Post-condition: A task is returned. Once it finishes, values[v] holds the shortest distance from source to v, and path[v] the vertex before v on that path, for v from 1 to the vertex count. Unreachable vertices have the largest int and 0.
+ */
+QueryTask<AsyncQuery::Result> AsyncQuery::shortestPaths(QueryExecutor& executor, const CSRGraph& graph, int source, Options options)
+{
+    co_await executor.schedule();
+
+    Result result;
+    int n = graph.getVertexCount();
+    if(source < 1 || source > n || options.yieldEvery < 1)
+    {
+        result.status = INVALID;
+        co_return result;
+    }
+    result.status = interrupted(options);
+    if(result.status != COMPLETE)
+    {
+        co_return result;
+    }
+
+    result.values.assign(n + 1, INT_MAX);
+    result.path.assign(n + 1, 0);
+    vector<bool> settled(n + 1, false);
+    PERF_COUNT(BYTES_ALLOCATED, 2 * (n + 1) * sizeof(int) + (n + 8) / 8);
+
+    typedef pair<int, int> Entry;                 // distance, vertex
+    priority_queue<Entry, vector<Entry>, greater<Entry> > heap;
+    size_t heapPeak = 0;                          // entries the heap storage has had to hold
+    result.values[source] = 0;
+    heap.push(Entry(0, source));
+
+    int sinceYield = 0;
+    while(!heap.empty())
+    {
+        Entry top = heap.top();
+        heap.pop();
+        int v = top.second;
+        if(settled[v])
+        {
+            continue;
+        }
+        settled[v] = true;
+        PERF_COUNT(VERTICES_SETTLED, 1);
+
+        for(long long e = graph.edgeBegin(v); e < graph.edgeEnd(v); e++)
+        {
+            PERF_COUNT(EDGES_RELAXED, 1);
+            int w = graph.getTarget(e);
+            if(!settled[w] && top.first + graph.getWeight(e) < result.values[w])
+            {
+                result.values[w] = top.first + graph.getWeight(e);
+                result.path[w] = v;
+                heap.push(Entry(result.values[w], w));
+                if(heap.size() > heapPeak)
+                {
+                    heapPeak = heap.size();
+                    PERF_COUNT(BYTES_ALLOCATED, sizeof(Entry));
+                }
+            }
+        }
+
+        sinceYield++;
+        if(sinceYield == options.yieldEvery)
+        {
+            sinceYield = 0;
+            co_await executor.schedule();
+            result.status = interrupted(options);
+            if(result.status != COMPLETE)
+            {
+                co_return result;
+            }
+        }
+    }
+
+    co_return result;
+}
+
+/*
+ allPairs:
+ Pre-condition: graph outlives the query.
+ Post-condition: A task is returned. Once it finishes, row s of values and path, each row being vertex count + 1 long, holds the shortestPaths result of source s, for s from 1 to the vertex count. Row 0 is unused.
+ */
+QueryTask<AsyncQuery::Result> AsyncQuery::allPairs(QueryExecutor& executor, const CSRGraph& graph, Options options)
+{
+    co_await executor.schedule();
+
+    Result result;
+    result.status = options.yieldEvery < 1 ? INVALID : COMPLETE;
+    if(result.status != COMPLETE)
+    {
+        co_return result;
+    }
+    int n = graph.getVertexCount();
+    result.values.assign((long long)(n + 1) * (n + 1), INT_MAX);
+    result.path.assign((long long)(n + 1) * (n + 1), 0);
+    PERF_COUNT(BYTES_ALLOCATED, 2 * (long long)(n + 1) * (n + 1) * sizeof(int));
+
+    // every source is a query of its own, so yields and checks happen inside each one
+    for(int source = 1; source <= n; source++)
+    {
+        Result row = co_await shortestPaths(executor, graph, source, options);
+        if(row.status != COMPLETE)
+        {
+            result.status = row.status;
+            co_return result;
+        }
+        copy(row.values.begin(), row.values.end(), result.values.begin() + (long long)source * (n + 1));
+        copy(row.path.begin(), row.path.end(), result.path.begin() + (long long)source * (n + 1));
+    }
+
+    co_return result;
+}
+
+/*
+ depthFirst:
+ Pre-condition: graph outlives the query.
+                start is the vertex to search from, or 0 to search from every vertex in turn.
+ Post-condition: A task is returned. Once it finishes, values holds the vertices in depth-first order, taking edges in their order in the graph like GraphL::depthFirstOrder.
+ */
+QueryTask<AsyncQuery::Result> AsyncQuery::depthFirst(QueryExecutor& executor, const CSRGraph& graph, int start, Options options)
+{
+    co_await executor.schedule();
+
+    Result result;
+    int n = graph.getVertexCount();
+    if(start < 0 || start > n || options.yieldEvery < 1)
+    {
+        result.status = INVALID;
+        co_return result;
+    }
+    result.status = interrupted(options);
+    if(result.status != COMPLETE)
+    {
+        co_return result;
+    }
+
+    // an explicit stack of (vertex, next edge) in place of recursion, so the search can suspend
+    vector<bool> visited(n + 1, false);
+    vector<pair<int, long long> > stack;
+    size_t stackPeak = 0;                         // entries the stack storage has had to hold
+    PERF_COUNT(BYTES_ALLOCATED, (n + 8) / 8);
+    int first = start == 0 ? 1 : start;
+    int last = start == 0 ? n : start;
+    int sinceYield = 0;
+
+    for(int root = first; root <= last; root++)
+    {
+        if(visited[root])
+        {
+            continue;
+        }
+        visited[root] = true;
+        result.values.push_back(root);
+        stack.push_back(pair<int, long long>(root, graph.edgeBegin(root)));
+        PERF_COUNT(BYTES_ALLOCATED, sizeof(int));
+        if(stack.size() > stackPeak)
+        {
+            stackPeak = stack.size();
+            PERF_COUNT(BYTES_ALLOCATED, sizeof(pair<int, long long>));
+        }
+
+        while(!stack.empty())
+        {
+            int v = stack.back().first;
+            long long& next = stack.back().second;
+            if(next == graph.edgeEnd(v))
+            {
+                stack.pop_back();
+                continue;
+            }
+
+            int w = graph.getTarget(next);
+            next++;
+            PERF_COUNT(EDGES_RELAXED, 1);
+            if(visited[w])
+            {
+                continue;
+            }
+            visited[w] = true;
+            result.values.push_back(w);
+            stack.push_back(pair<int, long long>(w, graph.edgeBegin(w)));
+            PERF_COUNT(VERTICES_SETTLED, 1);
+            PERF_COUNT(BYTES_ALLOCATED, sizeof(int));
+            if(stack.size() > stackPeak)
+            {
+                stackPeak = stack.size();
+                PERF_COUNT(BYTES_ALLOCATED, sizeof(pair<int, long long>));
+            }
+
+            sinceYield++;
+            if(sinceYield == options.yieldEvery)
+            {
+                sinceYield = 0;
+                co_await executor.schedule();
+                result.status = interrupted(options);
+                if(result.status != COMPLETE)
+                {
+                    co_return result;
+                }
+            }
+        }
+    }
+
+    co_return result;
+}
+
+/*
+ interrupted:
+ Pre-condition: None.
+ Post-condition: Returns CANCELLED or TIMED_OUT if the query has to stop, or COMPLETE if it may go on.
+ */
+AsyncQuery::Status AsyncQuery::interrupted(const Options& options)
+{
+    if(options.token.isCancelled())
+    {
+        return CANCELLED;
+    }
+    if(chrono::steady_clock::now() >= options.deadline)
+    {
+        return TIMED_OUT;
+    }
+    return COMPLETE;
+}
@@ -0,0 +1,128 @@
+/*****************************************************************/
+/* AsyncQuery.h
+/*
+/* Author: Hans Nicolaus
+/*
+/* This header file contains the interfaces of method implementations
+/* of the CancellationToken and AsyncQuery classes, which hides the
+/* implementations of all methods that are implemented in the
+/* AsyncQuery.cpp file.
+/*
+/* AsyncQuery runs shortest path and depth-first queries on a CSRGraph
+/* as coroutines on a QueryExecutor, for callers that must not block.
+/* Every query moves onto the executor before doing any work. After
+/* every Options::yieldEvery vertices it goes to the back of the
+/* executor queue, so one long query cannot hold a thread while others
+/* wait. It also checks its cancellation token and deadline at those
+/* points, and stops at once if either has run out. Nothing is printed:
+/* the outcome is in the Result.
+/*
+/*****************************************************************/
+
+#ifndef ASYNCQUERY_H
+#define ASYNCQUERY_H
+#include "csrgraph.h"
+#include "queryexecutor.h"
+#include "querytask.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+using namespace std;
+
+class CancellationToken
+{
+public:
+    /*
+     Default constructor:
+     Pre-condition: None.
+     Post-condition: A token that has not been cancelled. Copies share its state.
+     */
+    CancellationToken();
+
+    /*
+     cancel:
+     Pre-condition: None.
+     Post-condition: The token and all its copies are cancelled. Any thread may call it.
+     */
+    void cancel();
+
+    /*
+     isCancelled:
+     Pre-condition: None.
+     Post-condition: Returns true if cancel was called on the token or one of its copies.
+     */
+    bool isCancelled() const;
+
+private:
+    shared_ptr<atomic<bool> > cancelled;          // shared by all copies
+};
+
+class AsyncQuery
+{
+public:
+    /*
+     Status: how a query ended.
+     */
+    enum Status { COMPLETE, CANCELLED, TIMED_OUT, INVALID };
+
+    /*
+     Options: the limits a query runs under. Cancellation and the deadline
+     are only checked when the query yields, so yieldEvery has to be at
+     least 1. A query with a smaller yieldEvery ends at once as INVALID.
+     */
+    struct Options
+    {
+        CancellationToken token;                  // stops the query when cancelled
+
+        chrono::steady_clock::time_point deadline = chrono::steady_clock::time_point::max();
+
+        int yieldEvery = 1024;                    // vertices between two yields
+    };
+
+    /*
+     Result: what a query found. values and path are only complete when
+     status is COMPLETE.
+     */
+    struct Result
+    {
+        Status status;
+
+        vector<int> values;                       // distances, or vertices in visiting order
+
+        vector<int> path;                         // vertex before each vertex on its shortest path
+    };
+
+    /*
+     shortestPaths:
+     Pre-condition: graph outlives the query.
+                    source is the source vertex.
+     Post-condition: A task is returned. Once it finishes, values[v] holds the shortest distance from source to v, and path[v] the vertex before v on that path, for v from 1 to the vertex count. Unreachable vertices have the largest int and 0.
+     */
+    static QueryTask<Result> shortestPaths(QueryExecutor& executor, const CSRGraph& graph, int source, Options options);
+
+    /*
+     allPairs:
+     Pre-condition: graph outlives the query.
+     Post-condition: A task is returned. Once it finishes, row s of values and path, each row being vertex count + 1 long, holds the shortestPaths result of source s, for s from 1 to the vertex count. Row 0 is unused.
+     */
+    static QueryTask<Result> allPairs(QueryExecutor& executor, const CSRGraph& graph, Options options);
+
+    /*
+     depthFirst:
+     Pre-condition: graph outlives the query.
+                    start is the vertex to search from, or 0 to search from every vertex in turn.
+     Post-condition: A task is returned. Once it finishes, values holds the vertices in depth-first order, taking edges in their order in the graph like GraphL::depthFirstOrder.
+     */
+    static QueryTask<Result> depthFirst(QueryExecutor& executor, const CSRGraph& graph, int start, Options options);
+
+private:
+    /*
+     interrupted:
+     Pre-condition: None.
+     Post-condition: Returns CANCELLED or TIMED_OUT if the query has to stop, or COMPLETE if it may go on.
+     */
+    static Status interrupted(const Options& options);
+};
+
+#endif
@@ -0,0 +1,477 @@
+/*****************************************************************/
+/* CSRBuilder.cpp
+/*
+/* Author: Hans Nicolaus
+/*
+/* This file contains the implementations of the constructors and
+/* methods which interfaces are defined in the CSRBuilder.h file
+/*
+/*****************************************************************/
+
+#include "csrbuilder.h"
+#include "perfcounters.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <functional>
+#include <thread>
+
+const static long long BLOCKSIZE = 16 << 20;      // bytes of the edge section read at a time
+
+/*
+ runThreads:
+ Pre-condition: work can run on count threads at once.
+ Post-condition: work(t) has run for every t from 0 to count - 1, the calling thread taking t = 0.
+ */
+static void runThreads(int count, const function<void(int)>& work)
+{
+    vector<thread> helpers;
+    for(int t = 1; t < count; t++)
+    {
+        helpers.push_back(thread(work, t));
+    }
+    work(0);
+    for(int t = 0; t < (int)helpers.size(); t++)
+    {
+        helpers[t].join();
+    }
+}
+
+/*
+ Constructor:
+ Pre-condition: threads is the number of threads to use, or 0 for one per core.
+ Post-condition: The builder is ready and its report is empty.
+ */
+CSRBuilder::CSRBuilder(int threads) : threads(threads)
+{
+    if(this->threads <= 0)
+    {
+        this->threads = max(1, (int)thread::hardware_concurrency());
+    }
+    report.edgeCount = 0;
+    report.invalidCount = 0;
+    report.duplicateCount = 0;
+}
+
+/*
+ build:
+ Pre-condition: input is positioned at the start of a graph in the text file format.
+                weighted is true if edges have a distance, as in GraphM files, and false if they do not, as in GraphL files.
+ Post-condition: graph holds the edges of the graph and names its vertex descriptions, and input is positioned after the edge section. An edge whose ends are not vertices, or that loops back to its source in a weighted graph, is left out. Returns false if no graph was left in the file.
+ */
+bool CSRBuilder::build(ifstream& input, bool weighted, CSRGraph& graph, vector<string>& names)
+{
+    PERF_TIME(BUILD_GRAPH);
+
+    int vertexCount = 0;
+    if(!(input >> vertexCount) || vertexCount < 0)
+    {
+        return false;
+    }
+
+    report.edgeCount = 0;
+    report.invalidCount = 0;
+    report.duplicateCount = 0;
+    report.invalidLines.clear();
+    report.duplicateEdges.clear();
+
+    // move the cursor to the next line, ignoring \n character after the last >>
+    string discardEndline;
+    getline(input, discardEndline);
+
+    names.resize(vertexCount);
+    for(int i = 0; i < vertexCount; i++)
+    {
+        getline(input, names[i]);
+    }
+
+    vector<Piece> pieces;
+    string text;
+    bool ended = false;
+    while(!ended && input)
+    {
+        streampos start = input.tellg();
+        text.resize(BLOCKSIZE);
+        input.read(&text[0], BLOCKSIZE);
+        text.resize(input.gcount());
+        if(text.empty())
+        {
+            break;
+        }
+        if(input)
+        {
+            // the block has to end on a line end
+            string rest;
+            getline(input, rest);
+            text += rest;
+            text += '\n';
+        }
+
+        // cutting the block into one piece per thread, each ending on a line end
+        vector<long long> cut(threads + 1, (long long)text.size());
+        cut[0] = 0;
+        for(int t = 1; t < threads; t++)
+        {
+            long long at = max(cut[t - 1], (long long)text.size() * t / threads);
+            while(at < (long long)text.size() && at > 0 && text[at - 1] != '\n')
+            {
+                at++;
+            }
+            cut[t] = at;
+        }
+
+        int first = pieces.size();
+        pieces.resize(first + threads);
+        runThreads(threads, [&](int t)
+        {
+            parsePiece(text.data() + cut[t], cut[t + 1] - cut[t], cut[t], vertexCount, weighted, pieces[first + t]);
+        });
+
+        // anything after the end marker belongs to the next graph
+        for(int t = 0; t < threads; t++)
+        {
+            if(pieces[first + t].endMarker != -1)
+            {
+                pieces.resize(first + t + 1);
+                input.clear();
+                input.seekg(start + (streamoff)pieces[first + t].endMarker);
+                ended = true;
+                break;
+            }
+        }
+    }
+
+    long long lineBase = 0;
+    for(int i = 0; i < (int)pieces.size(); i++)
+    {
+        report.invalidCount += pieces[i].invalidCount;
+        for(int j = 0; j < (int)pieces[i].invalidLines.size() && (int)report.invalidLines.size() < MAXEXAMPLES; j++)
+        {
+            report.invalidLines.push_back(lineBase + pieces[i].invalidLines[j]);
+        }
+        lineBase += pieces[i].lines;
+    }
+
+    assemble(pieces, vertexCount, weighted, graph);
+    report.edgeCount = graph.getEdgeCount();
+    return true;
+}
+
+/*
+ parsePiece:
+ Pre-condition: text holds whole lines of the edge section.
+ Post-condition: piece holds the edges of those lines up to the end marker. Offsets in piece are relative to base.
+ */
+void CSRBuilder::parsePiece(const char* text, long long length, long long base, int vertexCount, bool weighted, Piece& piece) const
+{
+    piece.edges.clear();
+    piece.lines = 0;
+    piece.invalidCount = 0;
+    piece.invalidLines.clear();
+    piece.endMarker = -1;
+
+    int fields = weighted ? 3 : 2;
+    const char* end = text + length;
+    const char* line = text;
+    while(line < end)
+    {
+        const char* lineEnd = (const char*)memchr(line, '\n', end - line);
+        if(lineEnd == NULL)
+        {
+            lineEnd = end;
+        }
+        piece.lines++;
+
+        // reading up to three integers by hand, which is much faster than a stream
+        long long value[3] = {0, 0, 0};
+        int count = 0;
+        bool valid = true;
+        const char* c = line;
+        for(;;)
+        {
+            while(c < lineEnd && (*c == ' ' || *c == '\t' || *c == '\r'))
+            {
+                c++;
+            }
+            if(c == lineEnd)
+            {
+                break;
+            }
+            if(count == 3)
+            {
+                valid = false;
+                break;
+            }
+
+            bool negative = *c == '-';
+            if(negative)
+            {
+                c++;
+            }
+            if(c == lineEnd || *c < '0' || *c > '9')
+            {
+                valid = false;
+                break;
+            }
+            long long number = 0;
+            while(c < lineEnd && *c >= '0' && *c <= '9')
+            {
+                if(number <= INT_MAX)
+                {
+                    number = number * 10 + (*c - '0');
+                }
+                c++;
+            }
+            value[count] = negative ? -number : number;
+            count++;
+        }
+
+        if(valid && count == 0)
+        {
+            line = lineEnd + 1;
+            continue;
+        }
+        if(valid && count == fields && value[0] == 0 && value[1] == 0 && value[2] == 0)
+        {
+            piece.endMarker = base + (lineEnd - text) + (lineEnd < end ? 1 : 0);
+            return;
+        }
+
+        valid = valid && count == fields && value[0] >= 1 && value[0] <= vertexCount && value[1] >= 1 && value[1] <= vertexCount;
+        valid = valid && (!weighted || (value[0] != value[1] && value[2] >= INT_MIN && value[2] <= INT_MAX));
+        if(valid)
+        {
+            Edge edge = {(int)value[0], (int)value[1], weighted ? (int)value[2] : 1};
+            piece.edges.push_back(edge);
+        }
+        else
+        {
+            piece.invalidCount++;
+            if((int)piece.invalidLines.size() < MAXEXAMPLES)
+            {
+                piece.invalidLines.push_back(piece.lines);
+            }
+        }
+        line = lineEnd + 1;
+    }
+}
+
+/*
+ assemble:
+ Pre-condition: pieces hold every edge of the section in file order.
+                weighted is true if the edges come from a GraphM file.
+ Post-condition: graph holds the edges grouped by source. A weighted graph has repeats dropped and keeps file order. An unweighted graph keeps repeats and lists the edges of each vertex last first, as GraphL::buildGraph does.
+ */
+void CSRBuilder::assemble(vector<Piece>& pieces, int vertexCount, bool weighted, CSRGraph& graph)
+{
+    long long total = 0;
+    for(int i = 0; i < (int)pieces.size(); i++)
+    {
+        total += pieces[i].edges.size();
+    }
+
+    // every share needs a count per vertex, so there are only as many shares
+    // as keep those counts within the size of the edge arrays
+    int shares = (int)min((long long)threads, max(1LL, total / ((long long)vertexCount + 1)));
+
+    // each share is a run of pieces holding about an equal part of the edges
+    vector<int> firstPiece(shares + 1, pieces.size());
+    firstPiece[0] = 0;
+    long long seen = 0;
+    int t = 1;
+    for(int i = 0; i < (int)pieces.size() && t < shares; i++)
+    {
+        seen += pieces[i].edges.size();
+        while(t < shares && seen >= total * t / shares)
+        {
+            firstPiece[t] = i + 1;
+            t++;
+        }
+    }
+
+    // vertex ranges for the passes that go over vertices instead of edges
+    vector<int> firstVertex(threads + 1);
+    for(int r = 0; r <= threads; r++)
+    {
+        firstVertex[r] = 1 + (long long)vertexCount * r / threads;
+    }
+
+    // count: slot[t][v] is first the number of edges of v in share t
+    vector<vector<int> > slot(shares, vector<int>(vertexCount + 1, 0));
+    runThreads(shares, [&](int t)
+    {
+        for(int i = firstPiece[t]; i < firstPiece[t + 1]; i++)
+        {
+            for(int e = 0; e < (int)pieces[i].edges.size(); e++)
+            {
+                slot[t][pieces[i].edges[e].source]++;
+            }
+        }
+    });
+
+    // prefix sum: slot[t][v] becomes where share t starts among the edges of v
+    vector<long long> offsets(vertexCount + 2, 0);
+    runThreads(threads, [&](int r)
+    {
+        for(int v = firstVertex[r]; v < firstVertex[r + 1]; v++)
+        {
+            int running = 0;
+            for(int t = 0; t < shares; t++)
+            {
+                int count = slot[t][v];
+                slot[t][v] = running;
+                running += count;
+            }
+            offsets[v + 1] = running;
+        }
+    });
+    for(int v = 1; v <= vertexCount + 1; v++)
+    {
+        offsets[v] += offsets[v - 1];
+    }
+
+    // scatter: every share writes only its own slots
+    vector<int> targets(total);
+    vector<int> weights(total);
+    runThreads(shares, [&](int t)
+    {
+        for(int i = firstPiece[t]; i < firstPiece[t + 1]; i++)
+        {
+            for(int e = 0; e < (int)pieces[i].edges.size(); e++)
+            {
+                const Edge& edge = pieces[i].edges[e];
+                long long at = offsets[edge.source] + slot[t][edge.source]++;
+                targets[at] = edge.dest;
+                weights[at] = edge.weight;
+            }
+            vector<Edge>().swap(pieces[i].edges);
+        }
+    });
+    vector<vector<int> >().swap(slot);
+
+    // GraphL puts every edge at the head of its list, so its lists run from the last edge in the file to the first
+    if(!weighted)
+    {
+        runThreads(threads, [&](int r)
+        {
+            for(int v = firstVertex[r]; v < firstVertex[r + 1]; v++)
+            {
+                reverse(targets.begin() + offsets[v], targets.begin() + offsets[v + 1]);
+            }
+        });
+
+        graph.vertexCount = vertexCount;
+        graph.offsets.swap(offsets);
+        graph.targets.swap(targets);
+        graph.weights.swap(weights);
+        return;
+    }
+
+    // merge: of the edges of a vertex with the same dest, only the last one in the file is kept
+    vector<char> keep(total, 1);
+    vector<long long> kept(vertexCount + 2, 0);
+    vector<long long> duplicates(threads, 0);
+    vector<vector<pair<int, int> > > examples(threads);
+    runThreads(threads, [&](int r)
+    {
+        vector<pair<int, long long> > byDest;
+        for(int v = firstVertex[r]; v < firstVertex[r + 1]; v++)
+        {
+            byDest.clear();
+            for(long long e = offsets[v]; e < offsets[v + 1]; e++)
+            {
+                byDest.push_back(pair<int, long long>(targets[e], e));
+            }
+            sort(byDest.begin(), byDest.end());
+            long long distinct = byDest.size();
+            for(int i = 0; i + 1 < (int)byDest.size(); i++)
+            {
+                if(byDest[i].first == byDest[i + 1].first)
+                {
+                    keep[byDest[i].second] = 0;
+                    distinct--;
+                    duplicates[r]++;
+                    if((int)examples[r].size() < MAXEXAMPLES)
+                    {
+                        examples[r].push_back(pair<int, int>(v, byDest[i].first));
+                    }
+                }
+            }
+            kept[v + 1] = distinct;
+        }
+    });
+
+    for(int r = 0; r < threads; r++)
+    {
+        report.duplicateCount += duplicates[r];
+        for(int i = 0; i < (int)examples[r].size() && (int)report.duplicateEdges.size() < MAXEXAMPLES; i++)
+        {
+            report.duplicateEdges.push_back(examples[r][i]);
+        }
+    }
+
+    if(report.duplicateCount > 0)
+    {
+        for(int v = 1; v <= vertexCount + 1; v++)
+        {
+            kept[v] += kept[v - 1];
+        }
+
+        vector<int> keptTargets(kept[vertexCount + 1]);
+        vector<int> keptWeights(kept[vertexCount + 1]);
+        runThreads(threads, [&](int r)
+        {
+            for(int v = firstVertex[r]; v < firstVertex[r + 1]; v++)
+            {
+                long long at = kept[v];
+                for(long long e = offsets[v]; e < offsets[v + 1]; e++)
+                {
+                    if(keep[e])
+                    {
+                        keptTargets[at] = targets[e];
+                        keptWeights[at] = weights[e];
+                        at++;
+                    }
+                }
+            }
+        });
+        offsets.swap(kept);
+        targets.swap(keptTargets);
+        weights.swap(keptWeights);
+    }
+
+    graph.vertexCount = vertexCount;
+    graph.offsets.swap(offsets);
+    graph.targets.swap(targets);
+    graph.weights.swap(weights);
+}
+
+/*
+ getReport:
+ Pre-condition: None.
+ Post-condition: The report of the last graph built is returned.
+ */
+const CSRBuilder::BuildReport& CSRBuilder::getReport() const
+{
+    return report;
+}
+
+/*
+ displayReport:
+ Pre-condition: None.
+ Post-condition: A summary of the report is written as text.
+ */
+void CSRBuilder::displayReport(ReportWriter& writer) const
+{
+    writer << "Edges built: " << to_string(report.edgeCount) << '\n';
+    writer << "Invalid edges: " << to_string(report.invalidCount) << '\n';
+    for(int i = 0; i < (int)report.invalidLines.size(); i++)
+    {
+        writer << "  line " << to_string(report.invalidLines[i]) << " of the edge section" << '\n';
+    }
+    writer << "Duplicate edges: " << to_string(report.duplicateCount) << '\n';
+    for(int i = 0; i < (int)report.duplicateEdges.size(); i++)
+    {
+        writer << "  " << report.duplicateEdges[i].first << " -> " << report.duplicateEdges[i].second << '\n';
+    }
+}
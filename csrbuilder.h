@@ -0,0 +1,140 @@
+/*****************************************************************/
+/* CSRBuilder.h
+/*
+/* Author: Hans Nicolaus
+/*
+/* This header file contains the interfaces of method implementations
+/* of the CSRBuilder class, which hides the implementations
+/* of all methods that are implemented in the CSRBuilder.cpp file.
+/*
+/* A CSRBuilder reads one graph of the input text file straight into a
+/* CSRGraph on several threads, for edge sections too long to insert one
+/* edge at a time:
+/*   parse:    the edge section is read in large blocks, each block is
+/*             cut at line ends into one piece per thread, and every
+/*             thread parses its piece into its own edge list
+/*   count:    each thread counts the edges of each source vertex in its
+/*             share of the edges, and a prefix sum over vertices and
+/*             shares gives every share its own slots in the arrays.
+/*             A share costs one count per vertex, so a graph with few
+/*             edges per vertex is split into fewer shares than threads
+/*   scatter:  the threads copy their edges into those slots, so the
+/*             edges of a vertex stay in file order without any locking
+/*   merge:    in a weighted graph, repeated edges are dropped, the last
+/*             one in the file winning as it does in GraphM::insertEdge.
+/*             An unweighted graph keeps repeated edges and lists the
+/*             edges of each vertex last first instead, matching the
+/*             lists GraphL::buildGraph builds
+/* Invalid and repeated edges are counted in a BuildReport instead of
+/* printed, and only the first few are kept as examples.
+/*
+/*****************************************************************/
+
+#ifndef CSRBUILDER_H
+#define CSRBUILDER_H
+#include "csrgraph.h"
+#include "reportwriter.h"
+#include <fstream>
+#include <string>
+#include <vector>
+using namespace std;
+
+class CSRBuilder
+{
+public:
+    const static int MAXEXAMPLES = 16;            // examples kept of each kind of problem
+
+    /*
+     BuildReport: what was wrong with the edges of the last graph built.
+     Lines are counted from 1 at the first line of the edge section.
+     */
+    struct BuildReport
+    {
+        long long edgeCount;                      // edges in the graph built
+
+        long long invalidCount;                   // lines that were not a valid edge
+
+        long long duplicateCount;                 // edges dropped for repeating an earlier one, in weighted graphs only
+
+        vector<long long> invalidLines;           // the first invalid lines
+
+        vector<pair<int, int> > duplicateEdges;   // source and dest of the first repeated edges
+    };
+
+    /*
+     Constructor:
+     Pre-condition: threads is the number of threads to use, or 0 for one per core.
+     Post-condition: The builder is ready and its report is empty.
+     */
+    CSRBuilder(int threads = 0);
+
+    /*
+     build:
+     Pre-condition: input is positioned at the start of a graph in the text file format.
+                    weighted is true if edges have a distance, as in GraphM files, and false if they do not, as in GraphL files.
+     Post-condition: graph holds the edges of the graph and names its vertex descriptions, and input is positioned after the edge section. An edge whose ends are not vertices, or that loops back to its source in a weighted graph, is left out. Returns false if no graph was left in the file.
+     */
+    bool build(ifstream& input, bool weighted, CSRGraph& graph, vector<string>& names);
+
+    /*
+     getReport:
+     Pre-condition: None.
+     Post-condition: The report of the last graph built is returned.
+     */
+    const BuildReport& getReport() const;
+
+    /*
+     displayReport:
+     Pre-condition: None.
+     Post-condition: A summary of the report is written as text.
+     */
+    void displayReport(ReportWriter& writer) const;
+
+private:
+    /*
+     Edge: one parsed line of the edge section.
+     */
+    struct Edge
+    {
+        int source;
+        int dest;
+        int weight;
+    };
+
+    /*
+     Piece: what one thread parsed out of its part of a block.
+     */
+    struct Piece
+    {
+        vector<Edge> edges;
+
+        long long lines;                          // lines parsed, the end marker included
+
+        long long invalidCount;
+
+        vector<long long> invalidLines;           // counted from 1 within the piece
+
+        long long endMarker;                      // offset just past the end marker line in the block, or -1
+    };
+
+    /*
+     parsePiece:
+     Pre-condition: text holds whole lines of the edge section.
+     Post-condition: piece holds the edges of those lines up to the end marker. Offsets in piece are relative to base.
+     */
+    void parsePiece(const char* text, long long length, long long base, int vertexCount, bool weighted, Piece& piece) const;
+
+    /*
+     assemble:
+     Pre-condition: pieces hold every edge of the section in file order.
+                    weighted is true if the edges come from a GraphM file.
+     Post-condition: graph holds the edges grouped by source. A weighted graph has repeats dropped and keeps file order. An unweighted graph keeps repeats and lists the edges of each vertex last first, as GraphL::buildGraph does.
+     */
+    void assemble(vector<Piece>& pieces, int vertexCount, bool weighted, CSRGraph& graph);
+
+    int threads;                                  // threads used by build
+
+    BuildReport report;                           // problems with the last graph built
+};
+
+#endif
@@ -0,0 +1,257 @@
+/*****************************************************************/
+/* CSRGraph.cpp
+/*
+/* Author: Hans Nicolaus
+/*
+/* This file contains the implementations of the constructors and
+/* methods which interfaces are defined in the CSRGraph.h file
+/*
+/*****************************************************************/
+
+#include "csrgraph.h"
+#include <fstream>
+#include <cstring>
+
+/*
+ Default constructor:
+ Pre-condition: None.
+ Post-condition: The graph has no vertices and no edges.
+ */
+CSRGraph::CSRGraph() : vertexCount(0), offsets(2, 0)
+{
+}
+
+/*
+ assign:
+ Pre-condition: sources, dests and weights describe one edge per index, with vertices from 1 to vertexCount.
+ Post-condition: The graph holds exactly those edges, the edges of each vertex in the order they were given.
+ */
+void CSRGraph::assign(int vertexCount, const vector<int>& sources, const vector<int>& dests, const vector<int>& weights)
+{
+    this->vertexCount = vertexCount;
+    offsets.assign(vertexCount + 2, 0);
+
+    // counting the edges of each vertex, then turning the counts into offsets
+    for(int i = 0; i < (int)sources.size(); i++)
+    {
+        offsets[sources[i] + 1]++;
+    }
+    for(int v = 1; v <= vertexCount + 1; v++)
+    {
+        offsets[v] += offsets[v - 1];
+    }
+
+    targets.resize(sources.size());
+    this->weights.resize(sources.size());
+    vector<long long> next(offsets.begin(), offsets.end() - 1);
+    for(int i = 0; i < (int)sources.size(); i++)
+    {
+        long long slot = next[sources[i]]++;
+        targets[slot] = dests[i];
+        this->weights[slot] = weights[i];
+    }
+}
+
+/*
+ save:
+ Pre-condition: filename can be written.
+                blockVertices is the number of vertices per disk block.
+ Post-condition: The graph is written in the layout above. Returns false if the file could not be written.
+ */
+bool CSRGraph::save(const string& filename, int blockVertices) const
+{
+    ofstream output(filename.c_str(), ios::binary);
+    if(!output)
+    {
+        return false;
+    }
+
+    int maxWeight = 0;
+    for(long long e = 0; e < getEdgeCount(); e++)
+    {
+        if(weights[e] > maxWeight)
+        {
+            maxWeight = weights[e];
+        }
+    }
+
+    long long edgeCount = getEdgeCount();
+    output.write("GCSR", 4);
+    output.write((const char*)&vertexCount, sizeof(int));
+    output.write((const char*)&blockVertices, sizeof(int));
+    output.write((const char*)&maxWeight, sizeof(int));
+    output.write((const char*)&edgeCount, sizeof(long long));
+    output.write((const char*)offsets.data(), offsets.size() * sizeof(long long));
+
+    // edges are written in chunks so no copy of the whole edge array is needed
+    const long long CHUNK = 65536;
+    vector<int> record;
+    for(long long first = 0; first < edgeCount; first += CHUNK)
+    {
+        long long last = first + CHUNK < edgeCount ? first + CHUNK : edgeCount;
+        record.clear();
+        for(long long e = first; e < last; e++)
+        {
+            record.push_back(targets[e]);
+            record.push_back(weights[e]);
+        }
+        output.write((const char*)record.data(), record.size() * sizeof(int));
+    }
+
+    return (bool)output;
+}
+
+/*
+ load:
+ Pre-condition: filename was written by save.
+ Post-condition: The graph is read back entirely into memory. Returns false, leaving the graph empty, if the file could not be read or does not hold the layout above.
+ */
+bool CSRGraph::load(const string& filename)
+{
+    ifstream input(filename.c_str(), ios::binary | ios::ate);
+    long long fileSize = input ? (long long)input.tellg() : 0;
+    input.seekg(0);
+
+    char magic[4];
+    int blockVertices = 0;
+    int maxWeight = 0;
+    long long edgeCount = 0;
+
+    vertexCount = 0;
+    offsets.assign(2, 0);
+    targets.clear();
+    weights.clear();
+
+    input.read(magic, 4);
+    input.read((char*)&vertexCount, sizeof(int));
+    input.read((char*)&blockVertices, sizeof(int));
+    input.read((char*)&maxWeight, sizeof(int));
+    input.read((char*)&edgeCount, sizeof(long long));
+    if(!input || memcmp(magic, "GCSR", 4) != 0 || !checkLayout(vertexCount, edgeCount, fileSize))
+    {
+        vertexCount = 0;
+        return false;
+    }
+
+    offsets.resize(vertexCount + 2);
+    input.read((char*)offsets.data(), offsets.size() * sizeof(long long));
+    if(!input || !checkOffsets(offsets, edgeCount))
+    {
+        vertexCount = 0;
+        offsets.assign(2, 0);
+        return false;
+    }
+
+    // edges are read in chunks like save writes them, and every target must be a vertex
+    const long long CHUNK = 65536;
+    vector<int> record;
+    targets.resize(edgeCount);
+    weights.resize(edgeCount);
+    bool valid = true;
+    for(long long first = 0; first < edgeCount && valid; first += CHUNK)
+    {
+        long long last = first + CHUNK < edgeCount ? first + CHUNK : edgeCount;
+        record.resize(2 * (last - first));
+        input.read((char*)record.data(), record.size() * sizeof(int));
+        valid = (bool)input;
+        for(long long e = first; e < last && valid; e++)
+        {
+            targets[e] = record[2 * (e - first)];
+            weights[e] = record[2 * (e - first) + 1];
+            valid = targets[e] >= 1 && targets[e] <= vertexCount;
+        }
+    }
+
+    if(!valid)
+    {
+        vertexCount = 0;
+        offsets.assign(2, 0);
+        targets.clear();
+        weights.clear();
+    }
+    return valid;
+}
+
+/*
+ checkLayout:
+ Pre-condition: vertexCount and edgeCount were read from the header of a file fileSize bytes long.
+ Post-condition: Returns true if neither is negative and the file is exactly as long as the layout above needs, so nothing is sized from a header that does not match the file.
+ */
+bool CSRGraph::checkLayout(int vertexCount, long long edgeCount, long long fileSize)
+{
+    if(vertexCount < 0 || edgeCount < 0)
+    {
+        return false;
+    }
+
+    // compared by division, so a huge edgeCount cannot overflow
+    long long edgeBytes = fileSize - HEADERSIZE - ((long long)vertexCount + 2) * (long long)sizeof(long long);
+    long long recordSize = 2 * sizeof(int);
+    return edgeBytes >= 0 && edgeBytes % recordSize == 0 && edgeBytes / recordSize == edgeCount;
+}
+
+/*
+ checkOffsets:
+ Pre-condition: offsets holds the vertexCount + 2 offsets read from a file.
+ Post-condition: Returns true if they start at 0, never decrease and end at edgeCount, so every edge range lies inside the edges.
+ */
+bool CSRGraph::checkOffsets(const vector<long long>& offsets, long long edgeCount)
+{
+    if(offsets.empty() || offsets[0] != 0 || offsets.back() != edgeCount)
+    {
+        return false;
+    }
+    for(size_t v = 1; v < offsets.size(); v++)
+    {
+        if(offsets[v] < offsets[v - 1])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ getVertexCount, getEdgeCount:
+ Pre-condition: None.
+ Post-condition: The number of vertices or edges is returned.
+ */
+int CSRGraph::getVertexCount() const
+{
+    return vertexCount;
+}
+
+long long CSRGraph::getEdgeCount() const
+{
+    return targets.size();
+}
+
+/*
+ edgeBegin, edgeEnd:
+ Pre-condition: v is a vertex from 1 to vertexCount.
+ Post-condition: The index of the first edge of v, or one past its last edge, is returned.
+ */
+long long CSRGraph::edgeBegin(int v) const
+{
+    return offsets[v];
+}
+
+long long CSRGraph::edgeEnd(int v) const
+{
+    return offsets[v + 1];
+}
+
+/*
+ getTarget, getWeight:
+ Pre-condition: edge is an edge index.
+ Post-condition: The vertex the edge ends at, or its weight, is returned.
+ */
+int CSRGraph::getTarget(long long edge) const
+{
+    return targets[edge];
+}
+
+int CSRGraph::getWeight(long long edge) const
+{
+    return weights[edge];
+}
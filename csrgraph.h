@@ -0,0 +1,117 @@
+/*****************************************************************/
+/* CSRGraph.h
+/*
+/* Author: Hans Nicolaus
+/*
+/* This header file contains the interfaces of method implementations
+/* of the CSRGraph class, which hides the implementations
+/* of all methods that are implemented in the CSRGraph.cpp file.
+/*
+/* A CSRGraph stores a weighted directed graph in compressed sparse row
+/* form: the edges of vertex v are entries offsets[v] up to
+/* offsets[v + 1] of the targets and weights arrays. Vertices are
+/* numbered 1 to vertexCount like in the input files. It is the format
+/* GraphM and GraphL export to for the algorithms that work on graphs
+/* too large for their fixed size arrays.
+/*
+/* File layout written by save, all integers native:
+/*   header:  "GCSR", int32 vertexCount, int32 blockVertices,
+/*            int32 maxWeight, int64 edgeCount
+/*   offsets: vertexCount + 2 int64, entry v is the first edge of v
+/*   edges:   edgeCount records of int32 target, int32 weight
+/* Edges are grouped in blocks of blockVertices consecutive vertices,
+/* which is the unit ExternalGraph reads from disk.
+/*
+/*****************************************************************/
+
+#ifndef CSRGRAPH_H
+#define CSRGRAPH_H
+#include <string>
+#include <vector>
+using namespace std;
+
+class CSRGraph
+{
+    friend class CSRBuilder;              // fills the arrays directly, in parallel
+
+public:
+    const static int HEADERSIZE = 24;     // bytes before the offsets in a file
+
+    /*
+     Default constructor:
+     Pre-condition: None.
+     Post-condition: The graph has no vertices and no edges.
+     */
+    CSRGraph();
+
+    /*
+     assign:
+     Pre-condition: sources, dests and weights describe one edge per index, with vertices from 1 to vertexCount.
+     Post-condition: The graph holds exactly those edges, the edges of each vertex in the order they were given.
+     */
+    void assign(int vertexCount, const vector<int>& sources, const vector<int>& dests, const vector<int>& weights);
+
+    /*
+     save:
+     Pre-condition: filename can be written.
+                    blockVertices is the number of vertices per disk block.
+     Post-condition: The graph is written in the layout above. Returns false if the file could not be written.
+     */
+    bool save(const string& filename, int blockVertices) const;
+
+    /*
+     load:
+     Pre-condition: filename was written by save.
+     Post-condition: The graph is read back entirely into memory. Returns false, leaving the graph empty, if the file could not be read or does not hold the layout above.
+     */
+    bool load(const string& filename);
+
+    /*
+     checkLayout:
+     Pre-condition: vertexCount and edgeCount were read from the header of a file fileSize bytes long.
+     Post-condition: Returns true if neither is negative and the file is exactly as long as the layout above needs, so nothing is sized from a header that does not match the file.
+     */
+    static bool checkLayout(int vertexCount, long long edgeCount, long long fileSize);
+
+    /*
+     checkOffsets:
+     Pre-condition: offsets holds the vertexCount + 2 offsets read from a file.
+     Post-condition: Returns true if they start at 0, never decrease and end at edgeCount, so every edge range lies inside the edges.
+     */
+    static bool checkOffsets(const vector<long long>& offsets, long long edgeCount);
+
+    /*
+     getVertexCount, getEdgeCount:
+     Pre-condition: None.
+     Post-condition: The number of vertices or edges is returned.
+     */
+    int getVertexCount() const;
+    long long getEdgeCount() const;
+
+    /*
+     edgeBegin, edgeEnd:
+     Pre-condition: v is a vertex from 1 to vertexCount.
+     Post-condition: The index of the first edge of v, or one past its last edge, is returned.
+     */
+    long long edgeBegin(int v) const;
+    long long edgeEnd(int v) const;
+
+    /*
+     getTarget, getWeight:
+     Pre-condition: edge is an edge index.
+     Post-condition: The vertex the edge ends at, or its weight, is returned.
+     */
+    int getTarget(long long edge) const;
+    int getWeight(long long edge) const;
+
+private:
+    int vertexCount;                      // vertices are 1 to vertexCount
+
+    vector<long long> offsets;            // vertexCount + 2 entries
+
+    vector<int> targets;                  // vertex each edge ends at
+
+    vector<int> weights;                  // distance of each edge
+};
+
+#endif
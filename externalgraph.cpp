@@ -0,0 +1,319 @@
+/*****************************************************************/
+/* ExternalGraph.cpp
+/*
+/* Author: Hans Nicolaus
+/*
+/* This file contains the implementations of the constructors and
+/* methods which interfaces are defined in the ExternalGraph.h file
+/*
+/*****************************************************************/
+
+#include "externalgraph.h"
+#include "csrgraph.h"
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*
+ Default constructor:
+ Pre-condition: None.
+ Post-condition: No file is open.
+ */
+ExternalGraph::ExternalGraph() : fd(-1), vertexCount(0), blockVertices(1), maxWeight(0), edgesAt(0), memoryLimit(0), cachedBytes(0), blockReads(0)
+{
+}
+
+/*
+ ~ExternalGraph:
+ Pre-condition: None.
+ Post-condition: The file is closed and every cached block is deallocated.
+ */
+ExternalGraph::~ExternalGraph()
+{
+    if(fd != -1)
+    {
+        close(fd);
+    }
+}
+
+/*
+ open:
+ Pre-condition: filename was written by CSRGraph::save.
+                memoryLimit is the most bytes of edges to keep in memory at once.
+ Post-condition: The header and vertex offsets are read. Returns false if the file could not be read or does not match its header.
+ */
+bool ExternalGraph::open(const string& filename, long long memoryLimit)
+{
+    if(fd != -1)
+    {
+        close(fd);
+    }
+    cache.clear();
+    lru.clear();
+    cachedBytes = 0;
+    blockReads = 0;
+    this->memoryLimit = memoryLimit;
+
+    fd = ::open(filename.c_str(), O_RDONLY);
+    if(fd == -1)
+    {
+        return false;
+    }
+
+    // the header is checked against the file size before anything is sized from it
+    char header[CSRGraph::HEADERSIZE];
+    long long edgeCount = 0;
+    struct stat status;
+    bool valid = fstat(fd, &status) == 0 && readFully(header, sizeof(header), 0) && memcmp(header, "GCSR", 4) == 0;
+    if(valid)
+    {
+        memcpy(&vertexCount, header + 4, sizeof(int));
+        memcpy(&blockVertices, header + 8, sizeof(int));
+        memcpy(&maxWeight, header + 12, sizeof(int));
+        memcpy(&edgeCount, header + 16, sizeof(long long));
+        valid = CSRGraph::checkLayout(vertexCount, edgeCount, status.st_size);
+    }
+    if(valid)
+    {
+        offsets.resize((long long)vertexCount + 2);
+        valid = readFully(offsets.data(), offsets.size() * sizeof(long long), CSRGraph::HEADERSIZE) && CSRGraph::checkOffsets(offsets, edgeCount);
+    }
+
+    if(!valid)
+    {
+        close(fd);
+        fd = -1;
+        vertexCount = 0;
+        offsets.clear();
+        return false;
+    }
+    if(blockVertices < 1)
+    {
+        blockVertices = 1;
+    }
+    edgesAt = CSRGraph::HEADERSIZE + offsets.size() * sizeof(long long);
+
+    return true;
+}
+
+/*
+ shortestPaths:
+ Pre-condition: The file is open.
+                source is the source vertex.
+                delta is the bucket width, or 0 to use the largest edge weight.
+ Post-condition: dist[v] holds the shortest distance from source to v and path[v] the vertex before v on that path, for v from 1 to the vertex count. Unreachable vertices have the largest int and 0. Returns false if a block could not be read or is corrupt, and dist and path are then incomplete.
+ */
+bool ExternalGraph::shortestPaths(int source, vector<int>& dist, vector<int>& path, int delta)
+{
+    return search(source, dist, path, delta > 0 ? delta : max(maxWeight, 1), false);
+}
+
+/*
+ breadthFirst:
+ Pre-condition: The file is open.
+                source is the vertex to search from.
+ Post-condition: level[v] holds the number of edges on the shortest path from source to v, or the largest int if v cannot be reached. Returns false if a block could not be read or is corrupt, and level is then incomplete.
+ */
+bool ExternalGraph::breadthFirst(int source, vector<int>& level)
+{
+    // with every edge counting 1 and buckets 1 wide, each bucket is one level
+    vector<int> path;
+    return search(source, level, path, 1, true);
+}
+
+/*
+ search:
+ Pre-condition: The file is open.
+ Post-condition: dist and path hold the result of delta-stepping from source, counting every edge as 1 if unitWeights is true. A vertex the largest int or more away is unreachable. Returns false if a block could not be read.
+ */
+bool ExternalGraph::search(int source, vector<int>& dist, vector<int>& path, int delta, bool unitWeights)
+{
+    dist.assign(vertexCount + 1, std::numeric_limits<int>::max());
+    path.assign(vertexCount + 1, 0);
+    if(source < 1 || source > vertexCount)
+    {
+        return true;
+    }
+
+    // every vertex sits in at most one bucket, so the buckets never hold more than the vertex count
+    map<long long, vector<int> > buckets;         // bucket number -> vertices
+    vector<long long> bucketOf(vertexCount + 1, NOBUCKET);
+    vector<int> position(vertexCount + 1, 0);     // index of each vertex in its bucket
+    vector<int> frontier;
+    dist[source] = 0;
+    bucketOf[source] = 0;
+    buckets[0].push_back(source);
+
+    while(!buckets.empty())
+    {
+        long long current = buckets.begin()->first;
+
+        // relax the smallest bucket until no vertex falls back into it
+        while(buckets.count(current) != 0)
+        {
+            frontier.swap(buckets[current]);
+            buckets.erase(current);
+            for(int i = 0; i < (int)frontier.size(); i++)
+            {
+                bucketOf[frontier[i]] = NOBUCKET;
+            }
+
+            // vertices in block order, so each block is read once per pass
+            sort(frontier.begin(), frontier.end());
+
+            for(int i = 0; i < (int)frontier.size(); i++)
+            {
+                int v = frontier[i];
+                const Block* block = getBlock(v / blockVertices);
+                if(block == NULL)
+                {
+                    return false;
+                }
+
+                for(long long e = offsets[v]; e < offsets[v + 1]; e++)
+                {
+                    int w = block->edges[2 * (e - block->firstEdge)];
+                    int weight = unitWeights ? 1 : block->edges[2 * (e - block->firstEdge) + 1];
+
+                    // summed in 64 bits, so a distance past the largest int stays unreachable instead of wrapping
+                    long long candidate = (long long)dist[v] + weight;
+                    if(candidate >= dist[w])
+                    {
+                        continue;
+                    }
+                    dist[w] = candidate;
+                    path[w] = v;
+
+                    // a vertex that moves to a nearer bucket leaves its old one, swapping the last entry into its place
+                    long long next = candidate / delta;
+                    if(bucketOf[w] == next)
+                    {
+                        continue;
+                    }
+                    if(bucketOf[w] != NOBUCKET)
+                    {
+                        vector<int>& old = buckets[bucketOf[w]];
+                        old[position[w]] = old.back();
+                        position[old.back()] = position[w];
+                        old.pop_back();
+                        if(old.empty())
+                        {
+                            buckets.erase(bucketOf[w]);
+                        }
+                    }
+                    vector<int>& bucket = buckets[next];
+                    bucketOf[w] = next;
+                    position[w] = bucket.size();
+                    bucket.push_back(w);
+                }
+            }
+        }
+    }
+    return true;
+}
+
+/*
+ getBlock:
+ Pre-condition: block is a block number of the file.
+ Post-condition: The block is returned, read from disk first if it is not cached. Least recently used blocks are dropped until the cache fits the memory limit, but the block asked for is always kept. NULL is returned if the block could not be read in full, or holds a target that is not a vertex or a negative weight.
+ */
+const ExternalGraph::Block* ExternalGraph::getBlock(int block)
+{
+    unordered_map<int, Block>::iterator found = cache.find(block);
+    if(found != cache.end())
+    {
+        lru.splice(lru.begin(), lru, found->second.age);
+        return &found->second;
+    }
+
+    int first = block * blockVertices;
+    int last = min(first + blockVertices, vertexCount + 1);
+    long long firstEdge = offsets[first];
+    long long edgeCount = offsets[last] - firstEdge;
+    long long bytes = edgeCount * 2 * sizeof(int);
+
+    while(!lru.empty() && cachedBytes + bytes > memoryLimit)
+    {
+        Block& oldest = cache[lru.back()];
+        cachedBytes -= oldest.edges.size() * sizeof(int);
+        cache.erase(lru.back());
+        lru.pop_back();
+    }
+
+    Block& loaded = cache[block];
+    loaded.firstEdge = firstEdge;
+    loaded.edges.resize(2 * edgeCount);
+    bool valid = readFully(loaded.edges.data(), bytes, edgesAt + firstEdge * 2 * sizeof(int));
+    for(long long e = 0; e < edgeCount && valid; e++)
+    {
+        valid = loaded.edges[2 * e] >= 1 && loaded.edges[2 * e] <= vertexCount && loaded.edges[2 * e + 1] >= 0;
+    }
+    if(!valid)
+    {
+        cache.erase(block);
+        return NULL;
+    }
+    lru.push_front(block);
+    loaded.age = lru.begin();
+
+    cachedBytes += bytes;
+    blockReads++;
+    return &loaded;
+}
+
+/*
+ readFully:
+ Pre-condition: The file is open.
+                buffer has room for bytes bytes.
+ Post-condition: bytes bytes from position at are in buffer, read in as many calls as the system needs. Returns false if an error or the end of the file came first.
+ */
+bool ExternalGraph::readFully(void* buffer, long long bytes, long long at)
+{
+    char* next = (char*)buffer;
+    while(bytes > 0)
+    {
+        ssize_t n = pread(fd, next, bytes, at);
+        if(n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if(n <= 0)
+        {
+            return false;
+        }
+        next += n;
+        bytes -= n;
+        at += n;
+    }
+    return true;
+}
+
+/*
+ getVertexCount:
+ Pre-condition: None.
+ Post-condition: The number of vertices in the file is returned.
+ */
+int ExternalGraph::getVertexCount() const
+{
+    return vertexCount;
+}
+
+/*
+ getBlockReads, getCachedBytes:
+ Pre-condition: None.
+ Post-condition: The number of blocks read from disk so far, or the bytes of edges now in memory, is returned.
+ */
+long long ExternalGraph::getBlockReads() const
+{
+    return blockReads;
+}
+
+long long ExternalGraph::getCachedBytes() const
+{
+    return cachedBytes;
+}
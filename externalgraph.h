@@ -0,0 +1,160 @@
+/*****************************************************************/
+/* ExternalGraph.h
+/*
+/* Author: Hans Nicolaus
+/*
+/* This header file contains the interfaces of method implementations
+/* of the ExternalGraph class, which hides the implementations
+/* of all methods that are implemented in the ExternalGraph.cpp file.
+/*
+/* An ExternalGraph answers shortest path and breadth-first queries on
+/* a graph saved by CSRGraph::save without reading its edges into
+/* memory. Only the vertex offsets stay resident. Edges are read one
+/* block of vertices at a time into a page cache that never holds more
+/* than the memory limit, least recently used blocks going first.
+/*
+/* Searches use delta-stepping: vertices are kept in buckets of width
+/* delta by tentative distance, and the smallest bucket is relaxed
+/* until it stops changing. Each pass over a bucket sorts its vertices
+/* by block, so every block is read at most once per pass instead of
+/* once per vertex as a binary heap would order them. A vertex whose
+/* distance drops moves to its new bucket, so the buckets hold each
+/* vertex at most once and search memory stays O(V).
+/*
+/* The header and offsets are checked against the file size when it is
+/* opened, and the edges of every block as it is read, so a truncated
+/* or corrupt file makes open or the search return false instead of
+/* sizing memory or indexing vertices from bad data.
+/*
+/*****************************************************************/
+
+#ifndef EXTERNALGRAPH_H
+#define EXTERNALGRAPH_H
+#include <string>
+#include <vector>
+#include <list>
+#include <unordered_map>
+using namespace std;
+
+class ExternalGraph
+{
+public:
+    /*
+     Default constructor:
+     Pre-condition: None.
+     Post-condition: No file is open.
+     */
+    ExternalGraph();
+
+    /*
+     ~ExternalGraph:
+     Pre-condition: None.
+     Post-condition: The file is closed and every cached block is deallocated.
+     */
+    ~ExternalGraph();
+
+    /*
+     open:
+     Pre-condition: filename was written by CSRGraph::save.
+                    memoryLimit is the most bytes of edges to keep in memory at once.
+     Post-condition: The header and vertex offsets are read. Returns false if the file could not be read or does not match its header.
+     */
+    bool open(const string& filename, long long memoryLimit);
+
+    /*
+     shortestPaths:
+     Pre-condition: The file is open.
+                    source is the source vertex.
+                    delta is the bucket width, or 0 to use the largest edge weight.
+     Post-condition: dist[v] holds the shortest distance from source to v and path[v] the vertex before v on that path, for v from 1 to the vertex count. Unreachable vertices have the largest int and 0. Returns false if a block could not be read or is corrupt, and dist and path are then incomplete.
+     */
+    bool shortestPaths(int source, vector<int>& dist, vector<int>& path, int delta = 0);
+
+    /*
+     breadthFirst:
+     Pre-condition: The file is open.
+                    source is the vertex to search from.
+     Post-condition: level[v] holds the number of edges on the shortest path from source to v, or the largest int if v cannot be reached. Returns false if a block could not be read or is corrupt, and level is then incomplete.
+     */
+    bool breadthFirst(int source, vector<int>& level);
+
+    /*
+     getVertexCount:
+     Pre-condition: None.
+     Post-condition: The number of vertices in the file is returned.
+     */
+    int getVertexCount() const;
+
+    /*
+     getBlockReads, getCachedBytes:
+     Pre-condition: None.
+     Post-condition: The number of blocks read from disk so far, or the bytes of edges now in memory, is returned.
+     */
+    long long getBlockReads() const;
+    long long getCachedBytes() const;
+
+private:
+    ExternalGraph(const ExternalGraph&);          // the file handle cannot be copied
+    ExternalGraph& operator=(const ExternalGraph&);
+
+    /*
+     Block: the edges of one range of vertices, read from disk. Each edge
+     is a target followed by a weight.
+     */
+    struct Block
+    {
+        vector<int> edges;                        // target, weight pairs
+
+        long long firstEdge;                      // index of the first edge
+
+        list<int>::iterator age;                  // place in the least recently used list
+    };
+
+    const static int NOBUCKET = -1;               // bucket number of a vertex in no bucket
+
+    /*
+     search:
+     Pre-condition: The file is open.
+     Post-condition: dist and path hold the result of delta-stepping from source, counting every edge as 1 if unitWeights is true. A vertex the largest int or more away is unreachable. Returns false if a block could not be read.
+     */
+    bool search(int source, vector<int>& dist, vector<int>& path, int delta, bool unitWeights);
+
+    /*
+     getBlock:
+     Pre-condition: block is a block number of the file.
+     Post-condition: The block is returned, read from disk first if it is not cached. Least recently used blocks are dropped until the cache fits the memory limit, but the block asked for is always kept. NULL is returned if the block could not be read in full, or holds a target that is not a vertex or a negative weight.
+     */
+    const Block* getBlock(int block);
+
+    /*
+     readFully:
+     Pre-condition: The file is open.
+                    buffer has room for bytes bytes.
+     Post-condition: bytes bytes from position at are in buffer, read in as many calls as the system needs. Returns false if an error or the end of the file came first.
+     */
+    bool readFully(void* buffer, long long bytes, long long at);
+
+    int fd;                                       // file descriptor, -1 when closed
+
+    int vertexCount;                              // vertices are 1 to vertexCount
+
+    int blockVertices;                            // vertices per block
+
+    int maxWeight;                                // largest edge weight in the file
+
+    long long edgesAt;                            // file position of the first edge
+
+    long long memoryLimit;                        // most bytes of edges kept
+
+    long long cachedBytes;                        // bytes of edges kept now
+
+    long long blockReads;                         // blocks read from disk
+
+    vector<long long> offsets;                    // first edge of each vertex
+
+    unordered_map<int, Block> cache;              // blocks in memory
+
+    list<int> lru;                                // cached blocks, most recent first
+};
+
+#endif
@@ -11,6 +11,7 @@
 #include "graphl.h"
 #include <limits>
 #include <fstream>
+#include <algorithm>
 
 /*
  Default constructor:
@@ -20,6 +21,7 @@
 GraphL::GraphL()
 {
     size = 0;
+    compressed = false;
     
     for(int i = 0; i < MAXNODES; i++)
     {
@@ -35,7 +37,10 @@ GraphL::GraphL()
  */
 void GraphL::buildGraph(ifstream& input)
 {
+    PERF_TIME(BUILD_GRAPH);
+    
     input >> size;
+    order.reset(size);
     
     // move the cursor tp the next line, ignoring \n character after the last >>
     string discardEndline;
@@ -57,6 +62,8 @@ void GraphL::buildGraph(ifstream& input)
         
         // setting all edgeHead to NULL, so that the Nodes without any adjacency is conditioned
         adjacencyList[i]->edgeHead = NULL;
+        
+        PERF_COUNT(BYTES_ALLOCATED, sizeof(GraphNode) + sizeof(NodeData));
     }
 
     int source = std::numeric_limits<int>::max();
@@ -73,6 +80,8 @@ void GraphL::buildGraph(ifstream& input)
             adjacencyList[source]->edgeHead->adjGraphNode = dest;
             
             adjacencyList[source]->edgeHead->nextEdge = temp;
+            
+            PERF_COUNT(BYTES_ALLOCATED, sizeof(EdgeNode));
         }
     }
     
@@ -80,6 +89,259 @@ void GraphL::buildGraph(ifstream& input)
     getline(input, discardEndline);
 }
 
+/*
+ reorderVertices:
+ Pre-condition: The adjacency list is filled with information from the text file.
+                ordering is the renumbering strategy.
+ Post-condition: The graph nodes are stored in the new order and every edge list is reallocated in that order, so that neighbouring vertices sit close together in memory. Every method keeps taking and reporting the vertex numbers of the input file, and the order of each edge list is unchanged.
+ */
+void GraphL::reorderVertices(VertexOrder::Ordering ordering)
+{
+    vector< vector<int> > lists(size + 1);
+    
+    // edges count in both directions, so a vertex sits near its in-neighbours too
+    vector< vector<int> > neighbours(size + 1);
+    for(int v = 1; v <= size; v++)
+    {
+        for(EdgeCursor edge(this, v); !edge.atEnd(); ++edge)
+        {
+            lists[v].push_back(*edge);
+            neighbours[v].push_back(*edge);
+            neighbours[*edge].push_back(v);
+        }
+    }
+    for(int v = 1; v <= size; v++)
+    {
+        sort(neighbours[v].begin(), neighbours[v].end());
+        neighbours[v].erase(unique(neighbours[v].begin(), neighbours[v].end()), neighbours[v].end());
+    }
+    
+    vector<int> newToOld;
+    VertexOrder::computeOrder(size, neighbours, ordering, newToOld);
+    
+    vector<int> oldToNew(size + 1, 0);
+    for(int n = 1; n <= size; n++)
+    {
+        oldToNew[newToOld[n]] = n;
+    }
+    
+    GraphNode* oldList[MAXNODES];
+    for(int v = 1; v <= size; v++)
+    {
+        oldList[v] = adjacencyList[v];
+    }
+    
+    vector< vector<int> > renamed(size + 1);
+    for(int v = 1; v <= size; v++)
+    {
+        adjacencyList[v] = oldList[newToOld[v]];
+        
+        for(int i = 0; i < (int)lists[newToOld[v]].size(); i++)
+        {
+            renamed[v].push_back(oldToNew[lists[newToOld[v]][i]]);
+        }
+    }
+    
+    // storing the edges again in vertex order keeps them near each other
+    replaceEdges(renamed);
+    
+    order.permute(newToOld);
+}
+
+/*
+ compressEdges:
+ Pre-condition: The adjacency list is filled with information from the text file.
+ Post-condition: Every edge list is stored as variable length byte codes in one shared array and the EdgeNode lists are deallocated. Each edge takes one or two bytes instead of a heap allocated EdgeNode, and the order of each edge list is unchanged.
+ */
+void GraphL::compressEdges()
+{
+    if(compressed)
+    {
+        return;
+    }
+    
+    vector< vector<int> > lists(size + 1);
+    for(int v = 1; v <= size; v++)
+    {
+        for(EdgeCursor edge(this, v); !edge.atEnd(); ++edge)
+        {
+            lists[v].push_back(*edge);
+        }
+    }
+    
+    compressed = true;
+    replaceEdges(lists);
+}
+
+/*
+ toCSR:
+ Pre-condition: The adjacency list is filled with information from the text file.
+                csr is the graph to be filled.
+ Post-condition: csr holds every edge with weight 1, numbered like the input text file, each edge list in list order.
+ */
+void GraphL::toCSR(CSRGraph& csr) const
+{
+    vector<int> sources;
+    vector<int> dests;
+    
+    for(int source = 1; source <= size; source++)
+    {
+        for(EdgeCursor edge(this, order.toInternal(source)); !edge.atEnd(); ++edge)
+        {
+            sources.push_back(source);
+            dests.push_back(order.toExternal(*edge));
+        }
+    }
+    
+    csr.assign(size, sources, dests, vector<int>(sources.size(), 1));
+}
+
+/*
+ replaceEdges:
+ Pre-condition: lists[v] holds the adjacent vertices of v, in list order, for v from 1 to size.
+ Post-condition: The current edges are deallocated and lists is stored in their place, compressed if the graph is compressed.
+ */
+void GraphL::replaceEdges(const vector< vector<int> >& lists)
+{
+    for(int v = 1; v <= size; v++)
+    {
+        while(adjacencyList[v]->edgeHead != NULL)
+        {
+            EdgeNode* temp = adjacencyList[v]->edgeHead->nextEdge;
+            delete adjacencyList[v]->edgeHead;
+            adjacencyList[v]->edgeHead = temp;
+        }
+    }
+    
+    if(!compressed)
+    {
+        for(int v = 1; v <= size; v++)
+        {
+            EdgeNode** tail = &adjacencyList[v]->edgeHead;
+            for(int i = 0; i < (int)lists[v].size(); i++)
+            {
+                *tail = new EdgeNode();
+                (*tail)->adjGraphNode = lists[v][i];
+                (*tail)->nextEdge = NULL;
+                tail = &(*tail)->nextEdge;
+            }
+        }
+        return;
+    }
+    
+    packedEdges.clear();
+    edgeStart.assign(size + 2, 0);
+    for(int v = 1; v <= size; v++)
+    {
+        edgeStart[v] = packedEdges.size();
+        
+        int previous = v;
+        for(int i = 0; i < (int)lists[v].size(); i++)
+        {
+            int delta = lists[v][i] - previous;
+            unsigned int code = ((unsigned int)delta << 1) ^ (unsigned int)(delta >> 31);
+            while(code >= 0x80)
+            {
+                packedEdges.push_back((code & 0x7F) | 0x80);
+                code >>= 7;
+            }
+            packedEdges.push_back(code);
+            previous = lists[v][i];
+        }
+    }
+    edgeStart[size + 1] = packedEdges.size();
+    packedEdges.shrink_to_fit();
+    
+    PERF_COUNT(BYTES_ALLOCATED, packedEdges.size() + edgeStart.size() * sizeof(unsigned int));
+}
+
+/*
+ EdgeCursor constructor:
+ Pre-condition: graph is the graph whose edges are walked.
+                source is the vertex whose edges are walked.
+ Post-condition: The cursor is at the first edge of source, or at the end if source has none.
+ */
+GraphL::EdgeCursor::EdgeCursor(const GraphL* graph, int source) : node(NULL), pos(NULL), end(NULL), current(source), packed(graph->compressed), done(false)
+{
+    if(packed)
+    {
+        pos = graph->packedEdges.data() + graph->edgeStart[source];
+        end = graph->packedEdges.data() + graph->edgeStart[source + 1];
+        decode();
+    }
+    else
+    {
+        node = graph->adjacencyList[source]->edgeHead;
+        done = node == NULL;
+    }
+}
+
+/*
+ atEnd:
+ Pre-condition: None.
+ Post-condition: Returns true once every edge has been visited.
+ */
+bool GraphL::EdgeCursor::atEnd() const
+{
+    return done;
+}
+
+/*
+ operator*:
+ Pre-condition: The cursor is not at the end.
+ Post-condition: The subscript of the adjacent graph node is returned.
+ */
+int GraphL::EdgeCursor::operator*() const
+{
+    return packed ? current : node->adjGraphNode;
+}
+
+/*
+ operator++:
+ Pre-condition: The cursor is not at the end.
+ Post-condition: The cursor is at the next edge, or at the end.
+ */
+GraphL::EdgeCursor& GraphL::EdgeCursor::operator++()
+{
+    if(packed)
+    {
+        decode();
+    }
+    else
+    {
+        node = node->nextEdge;
+        done = node == NULL;
+    }
+    return *this;
+}
+
+/*
+ decode:
+ Pre-condition: The graph is compressed.
+ Post-condition: The next edge is read into current, or the cursor is at the end if no bytes are left.
+ */
+void GraphL::EdgeCursor::decode()
+{
+    if(pos == end)
+    {
+        done = true;
+        return;
+    }
+    
+    unsigned int code = 0;
+    int shift = 0;
+    while(*pos & 0x80)
+    {
+        code |= (unsigned int)(*pos & 0x7F) << shift;
+        shift += 7;
+        pos++;
+    }
+    code |= (unsigned int)*pos << shift;
+    pos++;
+    
+    current += (int)(code >> 1) ^ -(int)(code & 1);
+}
+
 /*
  depthFirstSearch:
  Pre-condition: The adjacency list is filled with information from the text file.
@@ -87,16 +349,18 @@ void GraphL::buildGraph(ifstream& input)
  */
 void GraphL::depthFirstSearch()
 {
+    PERF_TIME(DFS);
+    
     cout << "Depth-first ordering: ";
     
     // start depth-first search from the first vertex until the last one
     for(int v = 1; v <= size; v++)
     {
         // making sure that all vertices are visited when function ends
-        if(!adjacencyList[v]->visited)
+        if(!adjacencyList[order.toInternal(v)]->visited)
         {
             // calling recursive function to perform depth-first search
-            DFS(v);
+            DFS(order.toInternal(v));
         }
     }
     
@@ -112,22 +376,85 @@ void GraphL::depthFirstSearch()
 void GraphL::DFS(int idx)
 {
     // printing out each vertex made as source in depth-first order
-    cout << idx << " ";
+    cout << order.toExternal(idx) << " ";
     // marking visited for the vertex
     adjacencyList[idx]->visited = true;
-    EdgeNode* curr = adjacencyList[idx]->edgeHead;
+    PERF_COUNT(VERTICES_SETTLED, 1);
     
     // keep on iterating until entire adjacent vertices of the source vertex is visited
-    while(curr != NULL)
+    for(EdgeCursor edge(this, idx); !edge.atEnd(); ++edge)
     {
         // calling itself (recursively) untill all adjacent vertices of a
         // source vertex is visited
-        if(!adjacencyList[curr->adjGraphNode]->visited)
+        PERF_COUNT(EDGES_RELAXED, 1);
+        if(!adjacencyList[*edge]->visited)
         {
-            DFS(curr->adjGraphNode);
+            DFS(*edge);
+        }
+    }
+}
+
+/*
+ depthFirstOrder:
+ Pre-condition: The adjacency list is filled with information from the text file.
+                start is the vertex to search from, or 0 to search from every vertex in turn like depthFirstSearch.
+                ordering is where the vertices are written.
+ Post-condition: ordering holds the vertices in depth-first order. The visited flags of the graph are not touched, so several threads may search the same graph at once.
+ */
+void GraphL::depthFirstOrder(int start, vector<int>& ordering) const
+{
+    PERF_TIME(DFS);
+    
+    ordering.clear();
+    vector<bool> visited(size + 1, false);
+    
+    if(start != 0)
+    {
+        if(start >= 1 && start <= size)
+        {
+            collectDFS(order.toInternal(start), visited, ordering);
+        }
+        return;
+    }
+    
+    for(int v = 1; v <= size; v++)
+    {
+        if(!visited[order.toInternal(v)])
+        {
+            collectDFS(order.toInternal(v), visited, ordering);
+        }
+    }
+}
+
+/*
+ getSize:
+ Pre-condition: None.
+ Post-condition: The number of vertices in the graph is returned.
+ */
+int GraphL::getSize() const
+{
+    return size;
+}
+
+/*
+ collectDFS:
+ Pre-condition: idx is the next vertex to be ordered using depth-first search.
+                visited marks the vertices already ordered.
+ Post-condition: The vertex idx and all its unvisited adjacent vertices are appended to ordering in depth-first order.
+ */
+void GraphL::collectDFS(int idx, vector<bool>& visited, vector<int>& ordering) const
+{
+    ordering.push_back(order.toExternal(idx));
+    visited[idx] = true;
+    PERF_COUNT(VERTICES_SETTLED, 1);
+    
+    for(EdgeCursor edge(this, idx); !edge.atEnd(); ++edge)
+    {
+        PERF_COUNT(EDGES_RELAXED, 1);
+        if(!visited[*edge])
+        {
+            collectDFS(*edge, visited, ordering);
         }
-        
-        curr = curr->nextEdge;
     }
 }
 
@@ -138,34 +465,103 @@ void GraphL::DFS(int idx)
  */
 void GraphL::displayGraph()
 {
-    cout << "----------------------------------------" << endl;
-    cout << "Graph:" << endl;
-    cout << "----------------------------------------" << endl;
+    ReportWriter writer(cout);
+    displayGraph(writer);
+}
+
+/*
+ displayGraph:
+ Pre-condition: The adjacency list is completed and contains correct information based on the text file.
+                writer is the buffered report that receives the output.
+ Post-condition: All edges of each and every source vertex are appended to writer, in the console layout or as CSV, JSON lines or binary records depending on the format of writer.
+ */
+void GraphL::displayGraph(ReportWriter& writer)
+{
+    if(writer.getFormat() == ReportWriter::TEXT)
+    {
+        writer << "----------------------------------------" << '\n';
+        writer << "Graph:" << '\n';
+        writer << "----------------------------------------" << '\n';
+    }
+    else if(writer.getFormat() == ReportWriter::CSV)
+    {
+        writer << "source,dest" << '\n';
+    }
     
+    // nodes are listed by the vertex numbers of the input file
     for(int source = 1; source <= size; source++)
     {
-        cout << "Node " << source << "    " << *(adjacencyList[source]->data) <<endl;
-        cout << "----------------------------------------" << endl;
+        int from = order.toInternal(source);
         
-        EdgeNode* temp = adjacencyList[source]->edgeHead;
-        while(temp != NULL)
+        switch(writer.getFormat())
         {
-            cout << " edge " << source << " " <<temp->adjGraphNode << endl;
-            
-            temp = temp->nextEdge;
+            case ReportWriter::TEXT:
+                writer << "Node " << source << "    " << *(adjacencyList[from]->data) << '\n';
+                writer << "----------------------------------------" << '\n';
+                
+                for(EdgeCursor edge(this, from); !edge.atEnd(); ++edge)
+                {
+                    writer << " edge " << source << " " << order.toExternal(*edge) << '\n';
+                }
+                
+                if(source != size)
+                {
+                    writer << "========================================" << '\n';
+                }
+                else
+                {
+                    writer << "----------------------------------------" << '\n';
+                }
+                break;
+                
+            case ReportWriter::CSV:
+                for(EdgeCursor edge(this, from); !edge.atEnd(); ++edge)
+                {
+                    writer << source << ',' << order.toExternal(*edge) << '\n';
+                }
+                break;
+                
+            case ReportWriter::JSONL:
+            {
+                writer << "{\"source\":" << source << ",\"edges\":[";
+                bool first = true;
+                for(EdgeCursor edge(this, from); !edge.atEnd(); ++edge)
+                {
+                    if(!first)
+                    {
+                        writer << ',';
+                    }
+                    writer << order.toExternal(*edge);
+                    first = false;
+                }
+                writer << "]}" << '\n';
+                break;
+            }
+                
+            case ReportWriter::BINARY:
+            {
+                // record: source, edge count, adjacent vertices
+                int count = 0;
+                for(EdgeCursor edge(this, from); !edge.atEnd(); ++edge)
+                {
+                    count++;
+                }
+                
+                writer.writeBinary(source);
+                writer.writeBinary(count);
+                for(EdgeCursor edge(this, from); !edge.atEnd(); ++edge)
+                {
+                    writer.writeBinary(order.toExternal(*edge));
+                }
+                break;
+            }
         }
-	
-	if(source != size)
-	{
-		cout << "========================================" << endl;
-	}
-	else
-	{
-		cout << "----------------------------------------" << endl;
-	}
     }
     
-    cout << endl;
+    if(writer.getFormat() == ReportWriter::TEXT)
+    {
+        writer << '\n';
+    }
 }
 
 /*
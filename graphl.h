@@ -14,7 +14,12 @@
 #include <string>
 #include <iostream>
 #include <fstream>
+#include <vector>
 #include "nodedata.h"
+#include "reportwriter.h"
+#include "vertexorder.h"
+#include "perfcounters.h"
+#include "csrgraph.h"
 using namespace std;
 
 class GraphL
@@ -35,6 +40,29 @@ public:
      */
     void buildGraph(ifstream& input);
     
+    /*
+     reorderVertices:
+     Pre-condition: The adjacency list is filled with information from the text file.
+                    ordering is the renumbering strategy.
+     Post-condition: The graph nodes are stored in the new order and every edge list is reallocated in that order, so that neighbouring vertices sit close together in memory. Every method keeps taking and reporting the vertex numbers of the input file, and the order of each edge list is unchanged.
+     */
+    void reorderVertices(VertexOrder::Ordering ordering);
+    
+    /*
+     compressEdges:
+     Pre-condition: The adjacency list is filled with information from the text file.
+     Post-condition: Every edge list is stored as variable length byte codes in one shared array and the EdgeNode lists are deallocated. Each edge takes one or two bytes instead of a heap allocated EdgeNode, and the order of each edge list is unchanged.
+     */
+    void compressEdges();
+    
+    /*
+     toCSR:
+     Pre-condition: The adjacency list is filled with information from the text file.
+                    csr is the graph to be filled.
+     Post-condition: csr holds every edge with weight 1, numbered like the input text file, each edge list in list order.
+     */
+    void toCSR(CSRGraph& csr) const;
+    
     /*
      depthFirstSearch:
      Pre-condition: The adjacency list is filled with information from the text file.
@@ -42,6 +70,22 @@ public:
      */
     void depthFirstSearch();
     
+    /*
+     depthFirstOrder:
+     Pre-condition: The adjacency list is filled with information from the text file.
+                    start is the vertex to search from, or 0 to search from every vertex in turn like depthFirstSearch.
+                    ordering is where the vertices are written.
+     Post-condition: ordering holds the vertices in depth-first order. The visited flags of the graph are not touched, so several threads may search the same graph at once.
+     */
+    void depthFirstOrder(int start, vector<int>& ordering) const;
+    
+    /*
+     getSize:
+     Pre-condition: None.
+     Post-condition: The number of vertices in the graph is returned.
+     */
+    int getSize() const;
+    
     /*
      displayGraph:
      Pre-condition: The adjacency list is completed and contains correct information based on the text file.
@@ -49,6 +93,14 @@ public:
      */
     void displayGraph();
     
+    /*
+     displayGraph:
+     Pre-condition: The adjacency list is completed and contains correct information based on the text file.
+                    writer is the buffered report that receives the output.
+     Post-condition: All edges of each and every source vertex are appended to writer, in the console layout or as CSV, JSON lines or binary records depending on the format of writer.
+     */
+    void displayGraph(ReportWriter& writer);
+    
     /*
      ~GraphL:
      Pre-condition: GraphL is located in a function that is going out of scope.
@@ -64,6 +116,21 @@ private:
      */
     void DFS(int idx);
     
+    /*
+     collectDFS:
+     Pre-condition: idx is the next vertex to be ordered using depth-first search.
+                    visited marks the vertices already ordered.
+     Post-condition: The vertex idx and all its unvisited adjacent vertices are appended to ordering in depth-first order.
+     */
+    void collectDFS(int idx, vector<bool>& visited, vector<int>& ordering) const;
+    
+    /*
+     replaceEdges:
+     Pre-condition: lists[v] holds the adjacent vertices of v, in list order, for v from 1 to size.
+     Post-condition: The current edges are deallocated and lists is stored in their place, compressed if the graph is compressed.
+     */
+    void replaceEdges(const vector< vector<int> >& lists);
+    
     struct EdgeNode;      // forward reference for the compiler
     
     /*
@@ -93,6 +160,41 @@ private:
         EdgeNode* nextEdge; // pointer to the next adjacent node
         
     };
+    
+    /*
+     EdgeCursor: walks the edges of one vertex in list order, following
+     the EdgeNode list or decoding the compressed bytes, so traversals
+     work the same way in both modes. In the compressed bytes each edge
+     is the difference from the previous adjacent vertex (the source
+     vertex for the first edge), zigzag encoded so small negative
+     differences stay small, written 7 bits per byte with the high bit
+     set on every byte but the last.
+     */
+    class EdgeCursor {
+    public:
+        EdgeCursor(const GraphL* graph, int source);
+        
+        bool atEnd() const;            // whether every edge has been visited
+        
+        int operator*() const;         // subscript of the adjacent graph node
+        
+        EdgeCursor& operator++();      // step to the next edge
+        
+    private:
+        void decode();                 // read the next edge from the bytes
+        
+        const EdgeNode* node;          // current node when not compressed
+        
+        const unsigned char* pos;      // next byte to decode when compressed
+        
+        const unsigned char* end;      // end of the bytes of the vertex
+        
+        int current;                   // adjacent vertex of the current edge
+        
+        bool packed;                   // whether the bytes are decoded
+        
+        bool done;                     // whether every edge has been visited
+    };
   
     const static int MAXNODES = 100;
         
@@ -100,6 +202,14 @@ private:
         
     int size;                             // number of nodes in the graph
     
+    VertexOrder order;                    // input file numbers <-> list slots
+    
+    bool compressed;                      // whether edges live in packedEdges
+    
+    vector<unsigned char> packedEdges;    // edge lists of all vertices, encoded
+    
+    vector<unsigned int> edgeStart;       // edges of v are bytes edgeStart[v] up to edgeStart[v + 1]
+    
 };
 
 #endif
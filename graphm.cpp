@@ -11,6 +11,10 @@
 #include "graphm.h"
 #include <limits>
 #include <fstream>
+#include <algorithm>
+#include "labelpool.h"
+
+const static size_t LINEREPORT = 256;     // bytes reserved for the report of one path
 
 /*
  Default constructor:
@@ -28,10 +32,26 @@ GraphM::GraphM()
             T[row][col].path = 0;
             
             C[row][col] = std::numeric_limits<int>::max();
+            edgeMask[row][col] = false;
         }
+        vertexMask[row] = false;
+    }
+    
+    for(int row = 0; row < MAXNODES; row++)
+    {
+        solved[row] = false;
     }
     
     size = 0;
+    
+    for(int slot = 0; slot < NAMESLOTS; slot++)
+    {
+        nameIndex[slot].hash = 0;
+        nameIndex[slot].vertex = 0;
+    }
+    
+    // a path never holds more than every vertex once, so this is the only allocation
+    pathScratch.reserve(MAXNODES);
 }
 
 /*
@@ -42,7 +62,10 @@ GraphM::GraphM()
  */
 void GraphM::buildGraph(ifstream& input)
 {
+    PERF_TIME(BUILD_GRAPH);
+    
     input >> size;
+    order.reset(size);
     
     // move the cursor tp the next line, ignoring \n character after the last >>
     string discardEndline;
@@ -52,6 +75,7 @@ void GraphM::buildGraph(ifstream& input)
     {
         data[i].setData(input);
     }
+    buildNameIndex();
     
     int source = std::numeric_limits<int>::max();
     int dest = std::numeric_limits<int>::max();
@@ -69,6 +93,140 @@ void GraphM::buildGraph(ifstream& input)
     getline(input, discardEndline);
 }
 
+/*
+ reorderVertices:
+ Pre-condition: The adjacency matrix is filled with information from the text file.
+                ordering is the renumbering strategy.
+ Post-condition: The rows and columns of the adjacency matrix and the shortest path matrix, and the vertex data, are stored in the new order so that neighbouring vertices sit close together in memory. Every method keeps taking and reporting the vertex numbers of the input file.
+ */
+void GraphM::reorderVertices(VertexOrder::Ordering ordering)
+{
+    // edges count in both directions, so a vertex sits near its in-neighbours too
+    vector< vector<int> > neighbours(size + 1);
+    for(int v = 1; v <= size; v++)
+    {
+        for(int w = 1; w <= size; w++)
+        {
+            if(C[v][w] != std::numeric_limits<int>::max() || C[w][v] != std::numeric_limits<int>::max())
+            {
+                neighbours[v].push_back(w);
+            }
+        }
+    }
+    
+    vector<int> newToOld;
+    VertexOrder::computeOrder(size, neighbours, ordering, newToOld);
+    
+    vector<int> oldToNew(size + 1, 0);
+    for(int n = 1; n <= size; n++)
+    {
+        oldToNew[newToOld[n]] = n;
+    }
+    
+    // copy the rows that are about to move, then gather them in the new order
+    vector<int> oldC((size + 1) * (size + 1));
+    vector<TableType> oldT((size + 1) * (size + 1));
+    vector<NodeData> oldData(size + 1);
+    vector<bool> oldSolved(size + 1);
+    for(int v = 1; v <= size; v++)
+    {
+        for(int w = 1; w <= size; w++)
+        {
+            oldC[v * (size + 1) + w] = C[v][w];
+            oldT[v * (size + 1) + w] = T[v][w];
+        }
+        oldData[v] = data[v];
+        oldSolved[v] = solved[v];
+    }
+    
+    for(int v = 1; v <= size; v++)
+    {
+        int oldV = newToOld[v];
+        for(int w = 1; w <= size; w++)
+        {
+            int oldW = newToOld[w];
+            C[v][w] = oldC[oldV * (size + 1) + oldW];
+            T[v][w] = oldT[oldV * (size + 1) + oldW];
+            T[v][w].path = oldToNew[T[v][w].path];
+        }
+        data[v] = oldData[oldV];
+        solved[v] = oldSolved[oldV];
+    }
+    
+    order.permute(newToOld);
+}
+
+/*
+ buildNameIndex:
+ Pre-condition: The vertex data is read from the input text file.
+ Post-condition: The name index maps the description of every vertex to that vertex.
+ */
+void GraphM::buildNameIndex()
+{
+    for(int slot = 0; slot < NAMESLOTS; slot++)
+    {
+        nameIndex[slot].hash = 0;
+        nameIndex[slot].vertex = 0;
+    }
+    
+    for(int v = 1; v <= size; v++)
+    {
+        string_view name = trimmedName(v);
+        unsigned int h = LabelPool::hash(name);
+        
+        int slot = h & (NAMESLOTS - 1);
+        while(nameIndex[slot].vertex != 0 && !(nameIndex[slot].hash == h && trimmedName(nameIndex[slot].vertex) == name))
+        {
+            slot = (slot + 1) & (NAMESLOTS - 1);
+        }
+        if(nameIndex[slot].vertex == 0)
+        {
+            nameIndex[slot].hash = h;
+            nameIndex[slot].vertex = v;
+        }
+    }
+}
+
+/*
+ trimmedName:
+ Pre-condition: v is a vertex number from the input file.
+ Post-condition: The description of v is returned without the trailing whitespace, such as the \r the data files end lines with. It stays valid while the graph does.
+ */
+string_view GraphM::trimmedName(int v) const
+{
+    string_view name = data[order.toInternal(v)].getData();
+    while(!name.empty() && isspace((unsigned char)name.back()))
+    {
+        name.remove_suffix(1);
+    }
+    return name;
+}
+
+/*
+ findVertex:
+ Pre-condition: name is the description of a vertex. Trailing whitespace is ignored.
+ Post-condition: The vertex with that description is returned, or 0 if there is none. The first vertex wins if several share a description.
+ */
+int GraphM::findVertex(const string& name) const
+{
+    string_view trimmed = name;
+    while(!trimmed.empty() && isspace((unsigned char)trimmed.back()))
+    {
+        trimmed.remove_suffix(1);
+    }
+    
+    // the pool is not consulted, so lookups never wait on threads interning labels
+    unsigned int h = LabelPool::hash(trimmed);
+    for(int slot = h & (NAMESLOTS - 1); nameIndex[slot].vertex != 0; slot = (slot + 1) & (NAMESLOTS - 1))
+    {
+        if(nameIndex[slot].hash == h && trimmedName(nameIndex[slot].vertex) == trimmed)
+        {
+            return nameIndex[slot].vertex;
+        }
+    }
+    return 0;
+}
+
 /*
  insertEdge:
  Pre-condition: The source and destination vertex are valid.
@@ -86,11 +244,12 @@ void GraphM::insertEdge(int source, int dest, int weight)
     }
     else
     {
-        if(C[source][dest] != weight)
+        if(C[order.toInternal(source)][order.toInternal(dest)] != weight)
         {
             if(source >= 1 && source <= size && dest >= 1 && dest <= size && source != dest)
             {
-                C[source][dest] = weight;
+                C[order.toInternal(source)][order.toInternal(dest)] = weight;
+                invalidateSolved();
             }
             else
             {
@@ -117,7 +276,8 @@ void GraphM::removeEdge(int source, int dest)
 {
     if(source >= 1 && source <= size && dest >= 1 && dest <= size && source != dest)
     {
-        C[source][dest] = std::numeric_limits<int>::max();
+        C[order.toInternal(source)][order.toInternal(dest)] = std::numeric_limits<int>::max();
+        invalidateSolved();
         cout << "The following edge is removed: " << source << "->" << dest;
         cout << ". Please recompute shortest paths and distances";
         cout << " to get the updated shortest paths and distances." << endl;
@@ -130,6 +290,19 @@ void GraphM::removeEdge(int source, int dest)
     }
 }
 
+/*
+ invalidateSolved:
+ Pre-condition: The adjacency matrix has just been changed.
+ Post-condition: No row of the shortest path matrix is treated as current anymore.
+ */
+void GraphM::invalidateSolved()
+{
+    for(int row = 0; row < MAXNODES; row++)
+    {
+        solved[row] = false;
+    }
+}
+
 /*
  findV:
  Pre-condition: source is the source vertex.
@@ -139,6 +312,8 @@ void GraphM::removeEdge(int source, int dest)
  */
 int GraphM::findV(int source, int vCheck, int& min)
 {
+    PERF_COUNT(HEAP_OPERATIONS, 1);
+    
     if(vCheck == 1)
     {
         // comparing the source vertex with itself for every first comparison
@@ -174,16 +349,22 @@ int GraphM::findV(int source, int vCheck, int& min)
             }
         }
         
+        // a visited vertex can share the minimum distance, so it must be skipped; of several
+        // unvisited ones the lowest input file number goes first, so reordering cannot change paths
+        int next = 0;
         for(int vIdx = 1; vIdx <= size; vIdx++)
         {
-            if(min == T[source][vIdx].dist)
+            if(!T[source][vIdx].visited && min == T[source][vIdx].dist && (next == 0 || order.toExternal(vIdx) < order.toExternal(next)))
             {
-                T[source][vIdx].visited = true;
-                return vIdx;
+                next = vIdx;
             }
         }
-        // just so control path does not reach end of non-void
-        return 0;
+        if(next != 0)
+        {
+            T[source][next].visited = true;
+        }
+        // 0 if no vertex is left, just so control path does not reach end of non-void
+        return next;
     }
 }
 
@@ -194,6 +375,8 @@ int GraphM::findV(int source, int vCheck, int& min)
  */
 void GraphM::findShortestPath()
 {
+    PERF_TIME(FIND_SHORTEST_PATH);
+    
     for(int row = 0; row < MAXNODES; row++)
     {
         for(int col = 0; col < MAXNODES; col++)
@@ -206,185 +389,749 @@ void GraphM::findShortestPath()
     
     for (int source = 1; source <= size; source++)
     {
-        T[source][source].dist = 0;
-        int min = T[source][source].dist;
+        solveSource(source);
+    }
+}
+
+/*
+ solveSource:
+ Pre-condition: The adjacency matrix is filled with information from the text file.
+                source is a valid source vertex.
+ Post-condition: Row source of the shortest path matrix holds the shortest distances and predecessors from source to all other vertices, found by using Dijkstra algorithm, and the row is marked as current.
+ */
+void GraphM::solveSource(int source)
+{
+    // timed once per source, as timing every findV call would cost more than the scan itself
+    PERF_TIME(SOLVE_SOURCE);
+    
+    for(int col = 0; col < MAXNODES; col++)
+    {
+        T[source][col].visited = false;
+        T[source][col].dist = std::numeric_limits<int>::max();
+        T[source][col].path = 0;
+    }
+    
+    T[source][source].dist = 0;
+    int min = T[source][source].dist;
+    
+    // finds the shortest distance from source to all other nodes
+    for (int vCheck = 1; vCheck <= size; vCheck++)
+    {
+        // find v not visited, shortest distance at this point & mark v visited
+        int v = findV(source, vCheck, min);
         
-        // finds the shortest distance from source to all other nodes
-        for (int vCheck = 1; vCheck <= size; vCheck++)
+        // the vertices left are unreachable
+        if(v == 0)
         {
-            // find v not visited, shortest distance at this point & mark v visited
-            int v = findV(source, vCheck, min);
+            break;
+        }
+        PERF_COUNT(VERTICES_SETTLED, 1);
 
-            // for each w adjacent to v
-            for(int w = 1; w <= size; w++)
+        // for each w adjacent to v
+        for(int w = 1; w <= size; w++)
+        {
+            if(C[v][w] != std::numeric_limits<int>::max() && !T[source][w].visited)
             {
-                if(C[v][w] != std::numeric_limits<int>::max() && !T[source][w].visited)
+                // if (w is not visited)
+                if(T[source][w].dist > T[source][v].dist+C[v][w])
                 {
-                    // if (w is not visited)
-                    if(T[source][w].dist > T[source][v].dist+C[v][w])
-                    {
-                        T[source][w].dist = T[source][v].dist+C[v][w];
-                        T[source][w].path = v;
-                    }
+                    T[source][w].dist = T[source][v].dist+C[v][w];
+                    T[source][w].path = v;
+                    PERF_COUNT(EDGES_RELAXED, 1);
                 }
             }
         }
-        min = 0;
     }
+    
+    solved[source] = true;
+}
+
+/*
+ distanceTable:
+ Pre-condition: The adjacency matrix is filled with information from the text file.
+                sources and targets are the origin and destination vertices.
+                table points to at least sources.size() * targets.size() ints.
+ Post-condition: table[i * targets.size() + j] holds the shortest distance from sources[i] to targets[j], or the largest int if targets[j] cannot be reached or either vertex is invalid.
+ */
+void GraphM::distanceTable(const vector<int>& sources, const vector<int>& targets, int* table)
+{
+    int cols = targets.size();
+    
+    for(int i = 0; i < (int)sources.size(); i++)
+    {
+        int source = order.toInternal(sources[i]);
+        int* row = table + i * cols;
+        
+        if(source < 1 || source > size)
+        {
+            for(int j = 0; j < cols; j++)
+            {
+                row[j] = std::numeric_limits<int>::max();
+            }
+            continue;
+        }
+        
+        // one search per distinct source serves every target and every
+        // repeat of that source, and rows left by findShortestPath are reused
+        if(!solved[source])
+        {
+            solveSource(source);
+        }
+        
+        for(int j = 0; j < cols; j++)
+        {
+            int dest = order.toInternal(targets[j]);
+            if(dest >= 1 && dest <= size)
+            {
+                row[j] = T[source][dest].dist;
+            }
+            else
+            {
+                row[j] = std::numeric_limits<int>::max();
+            }
+        }
+    }
+}
+
+/*
+ buildPath:
+ Pre-condition: The shortest path matrix is completed and dest is reachable from source.
+ Post-condition: pathScratch holds the vertices from dest back to source, in that order, and the number of vertices is returned. The predecessor chain is walked only once and pathScratch keeps its capacity between calls.
+ */
+int GraphM::buildPath(int source, int dest)
+{
+    pathScratch.clear();
+    for(PathIterator it(this, source, dest); it != pathEnd(); ++it)
+    {
+        pathScratch.push_back(*it);
+    }
+    
+    return pathScratch.size();
 }
 
 /*
  shortestPath:
  Pre-condition: source is the source vertex.
                 dest is the destination vertex.
- Post-condition: All visited vertices that generates the shortest travel distance between the source and the destination vertex is displayed on console output.
+                writer is the buffered report that receives the output.
+ Post-condition: All visited vertices that generates the shortest travel distance between the source and the destination vertex is appended to writer.
  */
-void GraphM::shortestPath(int source, int dest)
+void GraphM::shortestPath(int source, int dest, ReportWriter& writer)
 {
     if(source >= 1 && source <= size && dest >= 1 && dest <= size && source != dest)
     {
-        int pathReverse[size];
-        for(int i = 1; i <= size; i++)
+        // the scratch path runs from dest back to source, so print it backwards
+        for(int i = buildPath(source, dest) - 1; i >= 0; i--)
         {
-            pathReverse[i] = 0;
+            writer << pathScratch[i] << ' ';
         }
-        if(source != dest)
+    }
+    else
+    {
+        writer << "Invalid input vertices, shortest path unavailable." << '\n';
+    }
+}
+
+/*
+ displayAll:
+ Pre-condition: The shortest path matrix is completed and contains correct information based on the adjacency matrix.
+ Post-condition: All information about each and every vertices will be displayed on the console output in an organized manner, which includes displaying the shortest distance and path between all source vertices with their adjacent vertices and the corresponding address of each source vertices.
+ */
+void GraphM::displayAll()
+{
+    ReportWriter writer(cout);
+    displayAll(writer);
+}
+
+/*
+ displayAll:
+ Pre-condition: The shortest path matrix is completed and contains correct information based on the adjacency matrix.
+                writer is the buffered report that receives the output.
+ Post-condition: The shortest distance and path between all source vertices and all other vertices are appended to writer, in the console table layout or as CSV, JSON lines or binary records depending on the format of writer.
+ */
+void GraphM::displayAll(ReportWriter& writer)
+{
+    switch(writer.getFormat())
+    {
+        case ReportWriter::CSV:
+            writer << "source,dest,dist,path" << '\n';
+            break;
+        case ReportWriter::TEXT:
+            writer << "-------------------------------------------------------------" << '\n';
+            writer << "Description           From_node  To_node  Dijkstra's  Path" << '\n';
+            writer << "-------------------------------------------------------------" << '\n';
+            break;
+        default:
+            break;
+    }
+    
+    // rows are listed by the vertex numbers of the input file
+    for(int from = 1; from <= size; from++)
+    {
+        int source = order.toInternal(from);
+        
+        if(writer.getFormat() == ReportWriter::TEXT)
         {
-            int i = 1;
-            pathReverse[i] = dest;
-            i++;
-            int temp = dest;
+            writer << data[source] << '\n';
+            writer << "-------------------------------------------------------------" << '\n';
+        }
         
-            while(temp != source)
+        for(int to = 1; to <= size; to++)
+        {
+            int dest = order.toInternal(to);
+            if(source == dest)
+            {
+                continue;
+            }
+            
+            bool reachable = T[source][dest].path != 0;
+            int length = reachable ? buildPath(source, dest) : 0;
+            
+            switch(writer.getFormat())
             {
-                pathReverse[i] = T[source][temp].path;
-                i++;
-                temp = T[source][temp].path;
+                case ReportWriter::TEXT:
+                    if(reachable)
+                    {
+                        writer << "                          " << from << "         " << to << "         " << T[source][dest].dist << "      ";
+                        for(int i = length - 1; i >= 0; i--)
+                        {
+                            writer << pathScratch[i] << ' ';
+                        }
+                        writer << '\n';
+                    }
+                    else
+                    {
+                        writer << "                          " << from << "         " << to << "         " << "----" << '\n';
+                    }
+                    break;
+                    
+                case ReportWriter::CSV:
+                    // unreachable pairs leave the dist and path columns empty
+                    writer << from << ',' << to << ',';
+                    if(reachable)
+                    {
+                        writer << T[source][dest].dist;
+                    }
+                    writer << ',';
+                    for(int i = length - 1; i >= 0; i--)
+                    {
+                        writer << pathScratch[i];
+                        if(i != 0)
+                        {
+                            writer << ' ';
+                        }
+                    }
+                    writer << '\n';
+                    break;
+                    
+                case ReportWriter::JSONL:
+                    writer << "{\"source\":" << from << ",\"dest\":" << to << ",\"dist\":";
+                    if(reachable)
+                    {
+                        writer << T[source][dest].dist;
+                    }
+                    else
+                    {
+                        writer << "null";
+                    }
+                    writer << ",\"path\":[";
+                    for(int i = length - 1; i >= 0; i--)
+                    {
+                        writer << pathScratch[i];
+                        if(i != 0)
+                        {
+                            writer << ',';
+                        }
+                    }
+                    writer << "]}" << '\n';
+                    break;
+                    
+                case ReportWriter::BINARY:
+                    // record: source, dest, dist (-1 if unreachable), path length, path
+                    writer.writeBinary(from);
+                    writer.writeBinary(to);
+                    writer.writeBinary(reachable ? T[source][dest].dist : -1);
+                    writer.writeBinary(length);
+                    for(int i = length - 1; i >= 0; i--)
+                    {
+                        writer.writeBinary(pathScratch[i]);
+                    }
+                    break;
             }
         }
-        for(int i = size; i >= 1; i--)
+        
+        if(writer.getFormat() == ReportWriter::TEXT)
         {
-            if(pathReverse[i] != 0)
+            if(from != size)
+            {
+                writer << "=============================================================" << '\n';
+            }
+            else
             {
-                cout << pathReverse[i] << " ";
+                writer << "-------------------------------------------------------------" << '\n';
             }
         }
     }
+}
+
+/*
+ displayPath:
+ Pre-condition: source is the source vertex.
+                dest is the destination vertex.
+                writer is the buffered report that receives the output.
+ Post-condition: The address for all visited vertices that generates the shortest travel distance between the source and the destination vertex is appended to writer.
+ */
+void GraphM::displayPath(int source, int dest, ReportWriter& writer)
+{
+    if(T[source][dest].dist != std::numeric_limits<int>::max())
+    {
+        for(int i = buildPath(source, dest) - 1; i >= 0; i--)
+        {
+            writer << data[order.toInternal(pathScratch[i])] << '\n';
+        }
+        writer << '\n';
+    }
     else
     {
-        cout << "Invalid input vertices, shortest path unavailable." << endl;
+        writer << '\n';
     }
 }
 
 /*
- displayAll:
- Pre-condition: The shortest path matrix is completed and contains correct information based on the adjacency matrix.
- Post-condition: All information about each and every vertices will be displayed on the console output in an organized manner, which includes displaying the shortest distance and path between all source vertices with their adjacent vertices and the corresponding address of each source vertices.
+ display:
+ Pre-condition: source is the source vertex.
+                dest is the destination vertex.
+ Post-condition: The source vertex, destination vertex, the shortest travel distance, the vertices travelled to reach destination vertex from source vertex that generates the shortest distance, and the corresponding address for all that vertices are displayed on console output.
  */
-void GraphM::displayAll()
+void GraphM::display(int source, int dest)
+{
+    ReportWriter writer(cout, ReportWriter::TEXT, LINEREPORT);
+    display(source, dest, writer);
+}
+
+/*
+ display:
+ Pre-condition: source is the source vertex.
+                dest is the destination vertex.
+                writer is the buffered report that receives the output.
+ Post-condition: The same information as display(int, int) is appended to writer, so a caller printing many paths can reuse one buffer.
+ */
+void GraphM::display(int source, int dest, ReportWriter& writer)
 {
-    cout << "-------------------------------------------------------------" << endl;
-    cout << "Description           From_node  To_node  Dijkstra's  Path" << endl;
-    cout << "-------------------------------------------------------------" << endl;
+    int from = order.toInternal(source);
+    int to = order.toInternal(dest);
+    
+    if(source >= 1 && source <= size && dest >= 1 && dest <= size && T[from][to].path != 0)
+    {
+        writer << source << "       " << dest << "      " << T[from][to].dist << "          ";
+        shortestPath(from, to, writer);
+        writer << '\n';
+        displayPath(from, to, writer);
+    }
+    else
+    {
+        writer << source << "       " << dest << "      " << "----" << '\n';
+        writer << '\n';
+    }
+}
+
+/*
+ display:
+ Pre-condition: source and dest are the descriptions of two vertices, as written in the input text file.
+ Post-condition: The same information as display(int, int) is displayed for the two vertices, or a message if a description does not belong to any vertex.
+ */
+void GraphM::display(const string& source, const string& dest)
+{
+    int from = findVertex(source);
+    int to = findVertex(dest);
+    
+    if(from == 0 || to == 0)
+    {
+        cout << "Location not found. Please provide valid input." << endl;
+        cout << endl;
+    }
+    else
+    {
+        display(from, to);
+    }
+}
+
+/*
+ pathBegin:
+ Pre-condition: The shortest path matrix is completed.
+                source is the source vertex.
+                dest is the destination vertex.
+ Post-condition: An iterator at dest is returned, which yields the shortest path from dest back to source. If dest cannot be reached from source, pathEnd() is returned.
+ */
+GraphM::PathIterator GraphM::pathBegin(int source, int dest) const
+{
+    int from = order.toInternal(source);
+    int to = order.toInternal(dest);
+    
+    if(source >= 1 && source <= size && dest >= 1 && dest <= size && T[from][to].dist != std::numeric_limits<int>::max())
+    {
+        return PathIterator(this, from, to);
+    }
+    return pathEnd();
+}
+
+/*
+ pathEnd:
+ Pre-condition: None.
+ Post-condition: The iterator that every PathIterator reaches after yielding the source vertex is returned.
+ */
+GraphM::PathIterator GraphM::pathEnd() const
+{
+    return PathIterator(this, 0, 0);
+}
+
+/*
+ getDistance:
+ Pre-condition: The shortest path matrix is completed.
+                source is the source vertex.
+                dest is the destination vertex.
+ Post-condition: The shortest distance from source to dest is returned, or the largest int if dest cannot be reached or either vertex is invalid.
+ */
+int GraphM::getDistance(int source, int dest) const
+{
+    if(source >= 1 && source <= size && dest >= 1 && dest <= size)
+    {
+        return T[order.toInternal(source)][order.toInternal(dest)].dist;
+    }
+    return std::numeric_limits<int>::max();
+}
+
+/*
+ getSize:
+ Pre-condition: None.
+ Post-condition: The number of vertices in the graph is returned.
+ */
+int GraphM::getSize() const
+{
+    return size;
+}
+
+/*
+ toCSR:
+ Pre-condition: The adjacency matrix is filled with information from the text file.
+                csr is the graph to be filled.
+ Post-condition: csr holds every edge of the adjacency matrix with its weight, numbered like the input text file.
+ */
+void GraphM::toCSR(CSRGraph& csr) const
+{
+    vector<int> sources;
+    vector<int> dests;
+    vector<int> weights;
+    
     for(int source = 1; source <= size; source++)
     {
-        cout << data[source] << endl;
-        cout << "-------------------------------------------------------------" << endl;
         for(int dest = 1; dest <= size; dest++)
         {
-            if(source != dest)
+            int weight = C[order.toInternal(source)][order.toInternal(dest)];
+            if(weight != std::numeric_limits<int>::max())
+            {
+                sources.push_back(source);
+                dests.push_back(dest);
+                weights.push_back(weight);
+            }
+        }
+    }
+    
+    csr.assign(size, sources, dests, weights);
+}
+
+/*
+ PathIterator constructor:
+ Pre-condition: graph is the graph whose shortest path matrix is walked.
+                source is the root of the shortest path tree.
+                vertex is the vertex to start from, or 0 for the end iterator.
+ Post-condition: The iterator is positioned at vertex.
+ */
+GraphM::PathIterator::PathIterator(const GraphM* graph, int source, int vertex) : graph(graph), source(source), vertex(vertex)
+{
+}
+
+/*
+ operator*:
+ Pre-condition: The iterator is not at the end.
+ Post-condition: The current vertex is returned.
+ */
+int GraphM::PathIterator::operator*() const
+{
+    return graph->order.toExternal(vertex);
+}
+
+/*
+ operator++:
+ Pre-condition: The iterator is not at the end.
+ Post-condition: The iterator moves to the predecessor of the current vertex, or to the end once the source vertex has been yielded.
+ */
+GraphM::PathIterator& GraphM::PathIterator::operator++()
+{
+    if(vertex == source)
+    {
+        vertex = 0;
+        source = 0;
+    }
+    else
+    {
+        vertex = graph->T[source][vertex].path;
+    }
+    return *this;
+}
+
+/*
+ operator!=:
+ Pre-condition: rhs walks the same graph.
+ Post-condition: Returns true if the two iterators are at different vertices.
+ */
+bool GraphM::PathIterator::operator!=(const PathIterator& rhs) const
+{
+    return vertex != rhs.vertex || source != rhs.source;
+}
+
+/*
+ kShortestPaths:
+ Pre-condition: The adjacency matrix is filled with information from the text file.
+                source is the source vertex.
+                dest is the destination vertex.
+                k is the number of paths wanted.
+ Post-condition: paths holds up to k loopless paths from source to dest, each from source to dest, in order of increasing distance, found with Yen's algorithm. costs holds the distance of each path. The number of paths found is returned.
+ */
+int GraphM::kShortestPaths(int source, int dest, int k, vector< vector<int> >& paths, vector<int>& costs)
+{
+    paths.clear();
+    costs.clear();
+    
+    int extSource = source;
+    int extDest = dest;
+    source = order.toInternal(extSource);
+    dest = order.toInternal(extDest);
+    
+    if(extSource < 1 || extSource > size || extDest < 1 || extDest > size || source == dest || k < 1)
+    {
+        return 0;
+    }
+    
+    // the best path comes straight from the shortest path tree of source
+    if(!solved[source])
+    {
+        solveSource(source);
+    }
+    if(T[source][dest].dist == std::numeric_limits<int>::max())
+    {
+        return 0;
+    }
+    paths.push_back(vector<int>(1, dest));
+    for(int v = dest; v != source; v = T[source][v].path)
+    {
+        paths[0].push_back(T[source][v].path);
+    }
+    reverse(paths[0].begin(), paths[0].end());
+    costs.push_back(T[source][dest].dist);
+    PERF_COUNT(BYTES_ALLOCATED, (paths[0].size() + 1) * sizeof(int));
+    
+    vector< vector<int> > candidates;     // paths found but not yet accepted
+    vector<int> candidateCosts;
+    vector<int> spurPath;
+    
+    while((int)paths.size() < k)
+    {
+        const vector<int> previous = paths.back();
+        int rootCost = 0;
+        
+        // every vertex of the previous path but dest is tried as a spur vertex
+        for(int spurIdx = 0; spurIdx + 1 < (int)previous.size(); spurIdx++)
+        {
+            int spur = previous[spurIdx];
+            
+            // hide the next edge of every accepted path sharing this root
+            for(int p = 0; p < (int)paths.size(); p++)
+            {
+                if((int)paths[p].size() > spurIdx + 1 && equal(previous.begin(), previous.begin() + spurIdx + 1, paths[p].begin()))
+                {
+                    edgeMask[spur][paths[p][spurIdx + 1]] = true;
+                }
+            }
+            
+            int spurCost = spurSearch(spur, dest, spurPath);
+            if(spurCost != std::numeric_limits<int>::max())
             {
-                if(T[source][dest].path != 0)
+                vector<int> candidate(previous.begin(), previous.begin() + spurIdx);
+                candidate.insert(candidate.end(), spurPath.begin(), spurPath.end());
+                
+                if(find(candidates.begin(), candidates.end(), candidate) == candidates.end())
                 {
-                    cout << "                          " << source << "         " << dest << "         " << T[source][dest].dist << "      ";
-                    shortestPath(source, dest);
-                    cout <<endl;
+                    candidates.push_back(candidate);
+                    candidateCosts.push_back(rootCost + spurCost);
+                    PERF_COUNT(BYTES_ALLOCATED, (candidate.size() + 1) * sizeof(int));
                 }
-                else
+            }
+            
+            for(int p = 0; p < (int)paths.size(); p++)
+            {
+                if((int)paths[p].size() > spurIdx + 1)
                 {
-                    cout << "                          " << source << "         " << dest << "         " << "----" <<  endl;
+                    edgeMask[paths[p][spurIdx]][paths[p][spurIdx + 1]] = false;
                 }
             }
+            
+            // the spur vertex joins the root, so later spurs may not revisit it
+            vertexMask[spur] = true;
+            rootCost += C[spur][previous[spurIdx + 1]];
         }
-        if(source != size)
+        
+        for(int i = 0; i + 1 < (int)previous.size(); i++)
         {
-            cout << "=============================================================" << endl;
+            vertexMask[previous[i]] = false;
         }
-        else
+        
+        if(candidates.empty())
         {
-            cout << "-------------------------------------------------------------" << endl;
+            break;
         }
         
+        int best = min_element(candidateCosts.begin(), candidateCosts.end()) - candidateCosts.begin();
+        paths.push_back(candidates[best]);
+        costs.push_back(candidateCosts[best]);
+        PERF_COUNT(BYTES_ALLOCATED, (candidates[best].size() + 1) * sizeof(int));
+        candidates.erase(candidates.begin() + best);
+        candidateCosts.erase(candidateCosts.begin() + best);
     }
+    
+    // the search runs on internal numbers, callers get input file numbers
+    for(int p = 0; p < (int)paths.size(); p++)
+    {
+        for(int i = 0; i < (int)paths[p].size(); i++)
+        {
+            paths[p][i] = order.toExternal(paths[p][i]);
+        }
+    }
+    PERF_COUNT(BYTES_ALLOCATED, spurPath.capacity() * sizeof(int));
+    
+    return paths.size();
 }
 
 /*
- displayPath:
- Pre-condition: source is the source vertex.
+ spurSearch:
+ Pre-condition: vertexMask and edgeMask mark the vertices and edges that may not be used.
+                spur is the vertex the search starts from.
                 dest is the destination vertex.
- Post-condition: The address for all visited vertices that generates the shortest travel distance between the source and the destination vertex is displayed on console output.
+                spurPath is where the path is written.
+ Post-condition: spurPath holds the shortest path from spur to dest that avoids every masked vertex and edge, and its distance is returned. If no such path exists, the largest int is returned. A current row of the shortest path matrix is used instead of a search when its path already avoids the masks.
  */
-void GraphM::displayPath(int source, int dest)
+int GraphM::spurSearch(int spur, int dest, vector<int>& spurPath)
 {
-    if(T[source][dest].dist != std::numeric_limits<int>::max())
-    {
-        int arraySize = 0;
+    spurPath.clear();
     
-        if(source != dest)
+    // the unmasked shortest path is still the best one if no mask touches it
+    if(solved[spur] && T[spur][dest].dist != std::numeric_limits<int>::max())
+    {
+        bool clear = true;
+        for(int v = dest; v != spur && clear; v = T[spur][v].path)
         {
-            arraySize++;
-            int temp = dest;
+            int u = T[spur][v].path;
+            clear = !vertexMask[v] && !edgeMask[u][v];
+            spurPath.push_back(v);
+        }
+        spurPath.push_back(spur);
         
-            while(temp != source)
-            {
-                arraySize++;
-                temp = T[source][temp].path;
-            }
+        if(clear)
+        {
+            reverse(spurPath.begin(), spurPath.end());
+            return T[spur][dest].dist;
         }
+        spurPath.clear();
+    }
     
-        int array[arraySize];
-    
-        array[1] = dest;
-        int temp = dest;
+    for(int v = 1; v <= size; v++)
+    {
+        spurTable[v].visited = false;
+        spurTable[v].dist = std::numeric_limits<int>::max();
+        spurTable[v].path = 0;
+    }
+    spurTable[spur].dist = 0;
     
-        int i = 2;
-        while(temp != source)
+    for(;;)
+    {
+        // find v not visited and not masked, with shortest distance at this point
+        int v = 0;
+        PERF_COUNT(HEAP_OPERATIONS, 1);
+        for(int w = 1; w <= size; w++)
         {
-            array[i] = T[source][temp].path;
-            temp = T[source][temp].path;
-            i++;
+            bool closer = v == 0 || spurTable[w].dist < spurTable[v].dist || (spurTable[w].dist == spurTable[v].dist && order.toExternal(w) < order.toExternal(v));
+            if(!spurTable[w].visited && !vertexMask[w] && spurTable[w].dist != std::numeric_limits<int>::max() && closer)
+            {
+                v = w;
+            }
         }
-    
-        for(int idx = arraySize; idx >= 1; idx--)
+        
+        if(v == 0)
         {
-            cout << data[array[idx]] << endl;
+            return std::numeric_limits<int>::max();
+        }
+        
+        spurTable[v].visited = true;
+        PERF_COUNT(VERTICES_SETTLED, 1);
+        if(v == dest)
+        {
+            break;
+        }
+        
+        for(int w = 1; w <= size; w++)
+        {
+            if(C[v][w] != std::numeric_limits<int>::max() && !edgeMask[v][w] && !vertexMask[w] && !spurTable[w].visited)
+            {
+                if(spurTable[w].dist > spurTable[v].dist + C[v][w])
+                {
+                    spurTable[w].dist = spurTable[v].dist + C[v][w];
+                    spurTable[w].path = v;
+                    PERF_COUNT(EDGES_RELAXED, 1);
+                }
+            }
         }
-        cout << endl;
     }
-    else
+    
+    for(int v = dest; v != spur; v = spurTable[v].path)
     {
-        cout << endl;
+        spurPath.push_back(v);
     }
+    spurPath.push_back(spur);
+    reverse(spurPath.begin(), spurPath.end());
+    
+    return spurTable[dest].dist;
 }
 
 /*
- display:
+ displayKShortest:
  Pre-condition: source is the source vertex.
                 dest is the destination vertex.
- Post-condition: The source vertex, destination vertex, the shortest travel distance, the vertices travelled to reach destination vertex from source vertex that generates the shortest distance, and the corresponding address for all that vertices are displayed on console output.
+                k is the number of paths wanted.
+ Post-condition: The rank, distance and vertices of up to k shortest loopless paths from source to dest are displayed on console output.
  */
-void GraphM::display(int source, int dest)
+void GraphM::displayKShortest(int source, int dest, int k)
 {
-    if(source >= 1 && source <= size && dest >= 1 && dest <= size && T[source][dest].path != 0)
+    vector< vector<int> > paths;
+    vector<int> costs;
+    int found = kShortestPaths(source, dest, k, paths, costs);
+    
+    ReportWriter writer(cout, ReportWriter::TEXT, LINEREPORT * (k > 0 ? k : 1));
+    
+    if(found == 0)
     {
-        cout << source << "       " << dest << "      " << T[source][dest].dist << "          ";
-        shortestPath(source, dest);
-        cout << endl;
-        displayPath(source, dest);
+        writer << source << "       " << dest << "      " << "----" << '\n';
+        writer << '\n';
+        return;
     }
-    else
+    
+    for(int rank = 0; rank < found; rank++)
     {
-        cout << source << "       " << dest << "      " << "----" <<  endl;
-        cout << endl;
+        writer << source << "       " << dest << "      " << (rank + 1) << "      " << costs[rank] << "          ";
+        for(int i = 0; i < (int)paths[rank].size(); i++)
+        {
+            writer << paths[rank][i] << ' ';
+        }
+        writer << '\n';
     }
+    writer << '\n';
 }
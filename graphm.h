@@ -14,12 +14,47 @@
 #include <string>
 #include <iostream>
 #include <fstream>
+#include <vector>
 #include "nodedata.h"
+#include "reportwriter.h"
+#include "vertexorder.h"
+#include "perfcounters.h"
+#include "csrgraph.h"
 using namespace std;
 
 class GraphM
 {
 public:
+    const static int MAXNODES = 100;      // maximum number of nodes possible
+    
+    typedef unsigned char PathIndex;      // smallest type holding a vertex
+    
+    static_assert(MAXNODES <= 256, "PathIndex is too narrow for MAXNODES");
+    
+    /*
+     PathIterator: walks the shortest path tree of one source vertex from a
+     destination vertex back to the source, yielding one vertex at a time
+     straight from the shortest path matrix without copying the path.
+     */
+    class PathIterator
+    {
+    public:
+        PathIterator(const GraphM* graph, int source, int vertex);
+        
+        int operator*() const;                          // current vertex
+        
+        PathIterator& operator++();                     // step to predecessor
+        
+        bool operator!=(const PathIterator& rhs) const;
+        
+    private:
+        const GraphM* graph;   // graph whose shortest path matrix is walked
+        
+        int source;            // root of the shortest path tree
+        
+        int vertex;            // current vertex, 0 once past the source
+    };
+    
     /*
      Default constructor:
      Pre-condition: Sufficient memory is available.
@@ -35,6 +70,14 @@ public:
      */
     void buildGraph(ifstream& input);
     
+    /*
+     reorderVertices:
+     Pre-condition: The adjacency matrix is filled with information from the text file.
+                    ordering is the renumbering strategy.
+     Post-condition: The rows and columns of the adjacency matrix and the shortest path matrix, and the vertex data, are stored in the new order so that neighbouring vertices sit close together in memory. Every method keeps taking and reporting the vertex numbers of the input file.
+     */
+    void reorderVertices(VertexOrder::Ordering ordering);
+    
     /*
      insertEdge:
      Pre-condition: The source and destination vertex, and their weight are valid.
@@ -61,6 +104,15 @@ public:
      */
     void findShortestPath();
     
+    /*
+     distanceTable:
+     Pre-condition: The adjacency matrix is filled with information from the text file.
+                    sources and targets are the origin and destination vertices.
+                    table points to at least sources.size() * targets.size() ints.
+     Post-condition: table[i * targets.size() + j] holds the shortest distance from sources[i] to targets[j], or the largest int if targets[j] cannot be reached or either vertex is invalid. Rows of the shortest path matrix that are still current are reused, and any other source is searched once.
+     */
+    void distanceTable(const vector<int>& sources, const vector<int>& targets, int* table);
+    
     /*
      displayAll:
      Pre-condition: The shortest path matrix is completed and contains correct information based on the adjacency matrix.
@@ -68,6 +120,14 @@ public:
      */
     void displayAll();
     
+    /*
+     displayAll:
+     Pre-condition: The shortest path matrix is completed and contains correct information based on the adjacency matrix.
+     writer is the buffered report that receives the output.
+     Post-condition: The shortest distance and path between all source vertices and all other vertices are appended to writer, in the console table layout or as CSV, JSON lines or binary records depending on the format of writer.
+     */
+    void displayAll(ReportWriter& writer);
+    
     /*
      display:
      Pre-condition: source is the source vertex.
@@ -75,23 +135,114 @@ public:
      Post-condition: The source vertex, destination vertex, the shortest travel distance, the vertices travelled to reach destination vertex from source vertex that generates the shortest distance, and the corresponding address for all that vertices are displayed on console output.
      */
     void display(int source, int dest);
+    
+    /*
+     display:
+     Pre-condition: source is the source vertex.
+     dest is the destination vertex.
+     writer is the buffered report that receives the output.
+     Post-condition: The same information as display(int, int) is appended to writer, so a caller printing many paths can reuse one buffer.
+     */
+    void display(int source, int dest, ReportWriter& writer);
+    
+    /*
+     display:
+     Pre-condition: source and dest are the descriptions of two vertices, as written in the input text file.
+     Post-condition: The same information as display(int, int) is displayed for the two vertices, or a message if a description does not belong to any vertex.
+     */
+    void display(const string& source, const string& dest);
+    
+    /*
+     findVertex:
+     Pre-condition: name is the description of a vertex. Trailing whitespace is ignored.
+     Post-condition: The vertex with that description is returned, or 0 if there is none. The first vertex wins if several share a description.
+     */
+    int findVertex(const string& name) const;
+    
+    /*
+     pathBegin:
+     Pre-condition: The shortest path matrix is completed.
+                    source is the source vertex.
+                    dest is the destination vertex.
+     Post-condition: An iterator at dest is returned, which yields the shortest path from dest back to source. If dest cannot be reached from source, pathEnd() is returned.
+     */
+    PathIterator pathBegin(int source, int dest) const;
+    
+    /*
+     pathEnd:
+     Pre-condition: None.
+     Post-condition: The iterator that every PathIterator reaches after yielding the source vertex is returned.
+     */
+    PathIterator pathEnd() const;
+    
+    /*
+     getDistance:
+     Pre-condition: The shortest path matrix is completed.
+                    source is the source vertex.
+                    dest is the destination vertex.
+     Post-condition: The shortest distance from source to dest is returned, or the largest int if dest cannot be reached or either vertex is invalid.
+     */
+    int getDistance(int source, int dest) const;
+    
+    /*
+     getSize:
+     Pre-condition: None.
+     Post-condition: The number of vertices in the graph is returned.
+     */
+    int getSize() const;
+    
+    /*
+     toCSR:
+     Pre-condition: The adjacency matrix is filled with information from the text file.
+                    csr is the graph to be filled.
+     Post-condition: csr holds every edge of the adjacency matrix with its weight, numbered like the input text file.
+     */
+    void toCSR(CSRGraph& csr) const;
+    
+    /*
+     kShortestPaths:
+     Pre-condition: The adjacency matrix is filled with information from the text file.
+                    source is the source vertex.
+                    dest is the destination vertex.
+                    k is the number of paths wanted.
+     Post-condition: paths holds up to k loopless paths from source to dest, each from source to dest, in order of increasing distance, found with Yen's algorithm. costs holds the distance of each path. The number of paths found is returned.
+     */
+    int kShortestPaths(int source, int dest, int k, vector< vector<int> >& paths, vector<int>& costs);
+    
+    /*
+     displayKShortest:
+     Pre-condition: source is the source vertex.
+                    dest is the destination vertex.
+                    k is the number of paths wanted.
+     Post-condition: The rank, distance and vertices of up to k shortest loopless paths from source to dest are displayed on console output.
+     */
+    void displayKShortest(int source, int dest, int k);
 
 private:
     /*
      displayPath:
      Pre-condition: source is the source vertex.
      dest is the destination vertex.
-     Post-condition: The address for all visited vertices that generates the shortest travel distance between the source and the destination vertex is displayed on console output.
+     writer is the buffered report that receives the output.
+     Post-condition: The address for all visited vertices that generates the shortest travel distance between the source and the destination vertex is appended to writer.
      */
-    void displayPath(int source, int dest);
+    void displayPath(int source, int dest, ReportWriter& writer);
     
     /*
      shortestPath:
      Pre-condition: source is the source vertex.
      dest is the destination vertex.
-     Post-condition: All visited vertices that generates the shortest travel distance between the source and the destination vertex is displayed on console output.
+     writer is the buffered report that receives the output.
+     Post-condition: All visited vertices that generates the shortest travel distance between the source and the destination vertex is appended to writer.
+     */
+    void shortestPath(int source, int dest, ReportWriter& writer);
+    
+    /*
+     buildPath:
+     Pre-condition: The shortest path matrix is completed and dest is reachable from source.
+     Post-condition: pathScratch holds the vertices from dest back to source, in that order, and the number of vertices is returned. The predecessor chain is walked only once and pathScratch keeps its capacity between calls.
      */
-    void shortestPath(int source, int dest);
+    int buildPath(int source, int dest);
     
     /*
      findV:
@@ -104,22 +255,59 @@ private:
     int findV(int source, int vCheck, int& min);
     
     /*
-     Node: a private struct that serves as a node in the BinTree object. Each
-     contains a NodeData pointer that points to a NodeData object that contains
-     a string as the data that are held in the BinTree object.
+     solveSource:
+     Pre-condition: The adjacency matrix is filled with information from the text file.
+                    source is a valid source vertex.
+     Post-condition: Row source of the shortest path matrix holds the shortest distances and predecessors from source to all other vertices, found by using Dijkstra algorithm, and the row is marked as current.
+     */
+    void solveSource(int source);
+    
+    /*
+     invalidateSolved:
+     Pre-condition: The adjacency matrix has just been changed.
+     Post-condition: No row of the shortest path matrix is treated as current anymore.
+     */
+    void invalidateSolved();
+    
+    /*
+     spurSearch:
+     Pre-condition: vertexMask and edgeMask mark the vertices and edges that may not be used.
+                    spur is the vertex the search starts from.
+                    dest is the destination vertex.
+                    spurPath is where the path is written.
+     Post-condition: spurPath holds the shortest path from spur to dest that avoids every masked vertex and edge, and its distance is returned. If no such path exists, the largest int is returned. A current row of the shortest path matrix is used instead of a search when its path already avoids the masks.
+     */
+    int spurSearch(int spur, int dest, vector<int>& spurPath);
+    
+    /*
+     buildNameIndex:
+     Pre-condition: The vertex data is read from the input text file.
+     Post-condition: The name index maps the description of every vertex to that vertex.
+     */
+    void buildNameIndex();
+    
+    /*
+     trimmedName:
+     Pre-condition: v is a vertex number from the input file.
+     Post-condition: The description of v is returned without the trailing whitespace, such as the \r the data files end lines with. It stays valid while the graph does.
+     */
+    string_view trimmedName(int v) const;
+    
+    /*
+     TableType: one entry of the shortest path matrix. The predecessor is
+     stored as a PathIndex, which is just wide enough for MAXNODES, and the
+     fields are ordered so an entry packs into 8 bytes instead of 12.
      */
     struct TableType
     {
-        bool visited;          // whether node has been visited
-        
         int dist;              // shortest distance from source known so far
         
-        int path;              // previous node in path of min dist
+        PathIndex path;        // previous node in path of min dist
+        
+        bool visited;          // whether node has been visited
         
     };
 
-    const static int MAXNODES = 100;      // maximum number of nodes possible
-    
     NodeData data[MAXNODES];              // data for graph nodes
     
     int C[MAXNODES][MAXNODES];            // Cost array, the adjacency matrix
@@ -127,6 +315,37 @@ private:
     int size;                             // number of nodes in the graph
     
     TableType T[MAXNODES][MAXNODES];      // stores visited, distance, path
+    
+    VertexOrder order;                    // input file numbers <-> storage rows
+    
+    bool solved[MAXNODES];                // whether row of T matches C
+    
+    vector<int> pathScratch;              // reused when rebuilding a path
+    
+    bool vertexMask[MAXNODES];            // vertices hidden from spurSearch
+    
+    bool edgeMask[MAXNODES][MAXNODES];    // edges hidden from spurSearch
+    
+    TableType spurTable[MAXNODES];        // distances used by spurSearch
+    
+    /*
+     NameSlot: one slot of the open addressing name index. The hash is
+     that of the trimmed description, which is compared against the
+     vertex's own label, so the index adds nothing to the LabelPool. The
+     vertex is 0 when the slot is empty.
+     */
+    struct NameSlot
+    {
+        unsigned int hash;     // LabelPool::hash of the trimmed description
+        
+        int vertex;            // vertex number from the input file
+    };
+    
+    const static int NAMESLOTS = 256;     // power of two, at most half full
+    
+    static_assert(NAMESLOTS >= 2 * MAXNODES, "name index would be too full");
+    
+    NameSlot nameIndex[NAMESLOTS];        // description -> vertex
 };
 
 #endif
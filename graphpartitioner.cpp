@@ -0,0 +1,362 @@
+/*****************************************************************/
+/* GraphPartitioner.cpp
+/*
+/* Author: Hans Nicolaus
+/*
+/* This file contains the implementations of the constructors and
+/* methods which interfaces are defined in the GraphPartitioner.h file
+/*
+/*****************************************************************/
+
+#include "graphpartitioner.h"
+#include <algorithm>
+#include <queue>
+#include <random>
+
+/*
+ partition:
+ Pre-condition: graph holds vertices from 1 to its vertex count.
+                parts is the number of parts, at least 1.
+                imbalance is how much heavier than average a part may be, as a factor.
+ Post-condition: part[v] holds the part of vertex v, from 0 to parts - 1, for v from 1 to the vertex count. The number of cut edges is returned.
+ */
+long long GraphPartitioner::partition(const CSRGraph& graph, int parts, vector<int>& part, double imbalance)
+{
+    int n = graph.getVertexCount();
+    part.assign(n + 1, 0);
+    if(parts <= 1 || n == 0)
+    {
+        return 0;
+    }
+
+    // the finest level is the graph without direction, self loops or repeated edges
+    vector<Level> levels(1);
+    {
+        vector<vector<int> > adjacent(n);
+        for(int v = 1; v <= n; v++)
+        {
+            for(long long e = graph.edgeBegin(v); e < graph.edgeEnd(v); e++)
+            {
+                int w = graph.getTarget(e);
+                if(w != v)
+                {
+                    adjacent[v - 1].push_back(w - 1);
+                    adjacent[w - 1].push_back(v - 1);
+                }
+            }
+        }
+
+        Level& finest = levels[0];
+        finest.xadj.push_back(0);
+        finest.vwgt.assign(n, 1);
+        for(int v = 0; v < n; v++)
+        {
+            sort(adjacent[v].begin(), adjacent[v].end());
+            for(int i = 0; i < (int)adjacent[v].size(); i++)
+            {
+                if(i > 0 && adjacent[v][i] == adjacent[v][i - 1])
+                {
+                    finest.adjwgt.back()++;
+                }
+                else
+                {
+                    finest.adjncy.push_back(adjacent[v][i]);
+                    finest.adjwgt.push_back(1);
+                }
+            }
+            vector<int>().swap(adjacent[v]);
+            finest.xadj.push_back(finest.adjncy.size());
+        }
+    }
+
+    // coarsening until the graph is small or stops shrinking
+    int smallEnough = max(20 * parts, 100);
+    while((int)levels.back().vwgt.size() > smallEnough)
+    {
+        levels.push_back(Level());
+        coarsen(levels[levels.size() - 2], levels.back());
+        if(levels.back().vwgt.size() * 20 > levels[levels.size() - 2].vwgt.size() * 19)
+        {
+            break;
+        }
+    }
+
+    int maxWeight = (int)(imbalance * n / parts) + 1;
+    vector<int> levelPart;
+    growParts(levels.back(), parts, levelPart);
+    refine(levels.back(), parts, maxWeight, levelPart);
+
+    // carrying the split back to each finer level and refining it there
+    for(int l = levels.size() - 2; l >= 0; l--)
+    {
+        vector<int> finer(levels[l].vwgt.size());
+        for(int v = 0; v < (int)finer.size(); v++)
+        {
+            finer[v] = levelPart[levels[l].cmap[v]];
+        }
+        levelPart.swap(finer);
+        levels.pop_back();
+        refine(levels[l], parts, maxWeight, levelPart);
+    }
+
+    for(int v = 1; v <= n; v++)
+    {
+        part[v] = levelPart[v - 1];
+    }
+    return cutEdges(graph, part);
+}
+
+/*
+ cutEdges:
+ Pre-condition: part holds a part for every vertex of graph.
+ Post-condition: The number of edges whose ends are in different parts is returned.
+ */
+long long GraphPartitioner::cutEdges(const CSRGraph& graph, const vector<int>& part)
+{
+    long long cut = 0;
+    for(int v = 1; v <= graph.getVertexCount(); v++)
+    {
+        for(long long e = graph.edgeBegin(v); e < graph.edgeEnd(v); e++)
+        {
+            if(part[graph.getTarget(e)] != part[v])
+            {
+                cut++;
+            }
+        }
+    }
+    return cut;
+}
+
+/*
+ coarsen:
+ Pre-condition: fine is a level.
+ Post-condition: fine.cmap maps each vertex to a vertex of coarse, which holds fine with matched pairs merged.
+ */
+void GraphPartitioner::coarsen(Level& fine, Level& coarse)
+{
+    int n = fine.vwgt.size();
+
+    // visiting in a fixed shuffled order, so the same graph always splits the same way
+    vector<int> order(n);
+    for(int v = 0; v < n; v++)
+    {
+        order[v] = v;
+    }
+    shuffle(order.begin(), order.end(), mt19937(n));
+
+    // heavy edge matching: each vertex pairs with the unmatched neighbour it shares the heaviest edge with
+    vector<int> match(n, -1);
+    fine.cmap.assign(n, -1);
+    int coarseCount = 0;
+    for(int i = 0; i < n; i++)
+    {
+        int v = order[i];
+        if(match[v] != -1)
+        {
+            continue;
+        }
+
+        int best = v;
+        int bestWeight = 0;
+        for(int e = fine.xadj[v]; e < fine.xadj[v + 1]; e++)
+        {
+            int w = fine.adjncy[e];
+            if(match[w] == -1 && w != v && fine.adjwgt[e] > bestWeight)
+            {
+                best = w;
+                bestWeight = fine.adjwgt[e];
+            }
+        }
+        match[v] = best;
+        match[best] = v;
+        fine.cmap[v] = coarseCount;
+        fine.cmap[best] = coarseCount;
+        coarseCount++;
+    }
+
+    // merging the edges of each pair, with marker holding where a neighbour already is
+    coarse.xadj.assign(1, 0);
+    coarse.vwgt.assign(coarseCount, 0);
+    coarse.adjncy.clear();
+    coarse.adjwgt.clear();
+    vector<int> marker(coarseCount, -1);
+    vector<int> members(coarseCount * 2, -1);
+    for(int v = 0; v < n; v++)
+    {
+        int c = fine.cmap[v];
+        members[2 * c + (members[2 * c] == -1 ? 0 : 1)] = v;
+    }
+
+    for(int c = 0; c < coarseCount; c++)
+    {
+        int first = coarse.adjncy.size();
+        for(int m = 0; m < 2 && members[2 * c + m] != -1; m++)
+        {
+            int v = members[2 * c + m];
+            coarse.vwgt[c] += fine.vwgt[v];
+            for(int e = fine.xadj[v]; e < fine.xadj[v + 1]; e++)
+            {
+                int target = fine.cmap[fine.adjncy[e]];
+                if(target == c)
+                {
+                    continue;
+                }
+                if(marker[target] < first)
+                {
+                    marker[target] = coarse.adjncy.size();
+                    coarse.adjncy.push_back(target);
+                    coarse.adjwgt.push_back(fine.adjwgt[e]);
+                }
+                else
+                {
+                    coarse.adjwgt[marker[target]] += fine.adjwgt[e];
+                }
+            }
+        }
+        coarse.xadj.push_back(coarse.adjncy.size());
+    }
+}
+
+/*
+ growParts:
+ Pre-condition: graph is the coarsest level.
+ Post-condition: part holds an initial split of graph into parts of about equal weight.
+ */
+void GraphPartitioner::growParts(const Level& graph, int parts, vector<int>& part)
+{
+    int n = graph.vwgt.size();
+    long long total = 0;
+    for(int v = 0; v < n; v++)
+    {
+        total += graph.vwgt[v];
+    }
+
+    // every part but the last grows from a seed until it holds its share
+    part.assign(n, parts - 1);
+    vector<bool> taken(n, false);
+    int nextSeed = 0;
+    long long grown = 0;
+    for(int p = 0; p < parts - 1; p++)
+    {
+        long long target = total * (p + 1) / parts - grown;
+        long long weight = 0;
+        queue<int> frontier;
+        while(weight < target)
+        {
+            if(frontier.empty())
+            {
+                // a new seed when the part cannot grow further from the last one
+                while(nextSeed < n && taken[nextSeed])
+                {
+                    nextSeed++;
+                }
+                if(nextSeed == n)
+                {
+                    break;
+                }
+                taken[nextSeed] = true;
+                frontier.push(nextSeed);
+            }
+
+            int v = frontier.front();
+            frontier.pop();
+            part[v] = p;
+            weight += graph.vwgt[v];
+            for(int e = graph.xadj[v]; e < graph.xadj[v + 1]; e++)
+            {
+                int w = graph.adjncy[e];
+                if(!taken[w])
+                {
+                    taken[w] = true;
+                    frontier.push(w);
+                }
+            }
+        }
+
+        // vertices queued but not reached go back to the pool
+        while(!frontier.empty())
+        {
+            taken[frontier.front()] = false;
+            frontier.pop();
+        }
+        nextSeed = 0;
+        grown += weight;
+    }
+}
+
+/*
+ refine:
+ Pre-condition: part holds a split of graph.
+                maxWeight is the most a part may weigh.
+ Post-condition: Boundary vertices were moved until no move reduces the cut or the balance.
+ */
+void GraphPartitioner::refine(const Level& graph, int parts, int maxWeight, vector<int>& part)
+{
+    int n = graph.vwgt.size();
+    vector<long long> partWeight(parts, 0);
+    for(int v = 0; v < n; v++)
+    {
+        partWeight[part[v]] += graph.vwgt[v];
+    }
+
+    // connection[p] is the weight of the edges from the current vertex into part p
+    vector<long long> connection(parts, 0);
+    vector<int> touched;
+    for(int pass = 0; pass < 8; pass++)
+    {
+        int moves = 0;
+        for(int v = 0; v < n; v++)
+        {
+            int from = part[v];
+            touched.clear();
+            for(int e = graph.xadj[v]; e < graph.xadj[v + 1]; e++)
+            {
+                int p = part[graph.adjncy[e]];
+                if(connection[p] == 0)
+                {
+                    touched.push_back(p);
+                }
+                connection[p] += graph.adjwgt[e];
+            }
+
+            int best = from;
+            long long bestGain = 0;
+            bool overweight = partWeight[from] > maxWeight;
+            for(int i = 0; i < (int)touched.size(); i++)
+            {
+                int to = touched[i];
+                if(to == from || partWeight[to] + graph.vwgt[v] > maxWeight)
+                {
+                    continue;
+                }
+
+                // a move must cut fewer edges, or cut as many and even out the parts,
+                // unless its own part is too heavy, where the least bad move is taken
+                long long gain = connection[to] - connection[from];
+                bool better = gain > bestGain || (gain == bestGain && best != from && partWeight[to] < partWeight[best]);
+                bool balances = gain == 0 && partWeight[to] + graph.vwgt[v] < partWeight[from];
+                if(better || (best == from && (balances || overweight)))
+                {
+                    best = to;
+                    bestGain = gain;
+                }
+            }
+            for(int i = 0; i < (int)touched.size(); i++)
+            {
+                connection[touched[i]] = 0;
+            }
+
+            if(best != from)
+            {
+                part[v] = best;
+                partWeight[from] -= graph.vwgt[v];
+                partWeight[best] += graph.vwgt[v];
+                moves++;
+            }
+        }
+        if(moves == 0)
+        {
+            break;
+        }
+    }
+}
@@ -0,0 +1,90 @@
+/*****************************************************************/
+/* GraphPartitioner.h
+/*
+/* Author: Hans Nicolaus
+/*
+/* This header file contains the interfaces of method implementations
+/* of the GraphPartitioner class, which hides the implementations
+/* of all methods that are implemented in the GraphPartitioner.cpp file.
+/*
+/* The GraphPartitioner splits the vertices of a CSRGraph into k parts
+/* of nearly equal size with few edges between parts, in three phases:
+/*   coarsening:     vertices are paired along their heaviest edge and
+/*                   merged, level after level, until the graph is small
+/*   initial:        the smallest graph is split by growing each part
+/*                   breadth first from a seed until it is full
+/*   refinement:     the split is carried back level by level, and at
+/*                   each level boundary vertices move to the neighbouring
+/*                   part they have the most edges to while balance allows
+/* Edge direction is ignored: an edge between two parts is cut whichever
+/* way it points.
+/*
+/*****************************************************************/
+
+#ifndef GRAPHPARTITIONER_H
+#define GRAPHPARTITIONER_H
+#include "csrgraph.h"
+#include <vector>
+using namespace std;
+
+class GraphPartitioner
+{
+public:
+    /*
+     partition:
+     Pre-condition: graph holds vertices from 1 to its vertex count.
+                    parts is the number of parts, at least 1.
+                    imbalance is how much heavier than average a part may be, as a factor.
+     Post-condition: part[v] holds the part of vertex v, from 0 to parts - 1, for v from 1 to the vertex count. The number of cut edges is returned.
+     */
+    static long long partition(const CSRGraph& graph, int parts, vector<int>& part, double imbalance = 1.03);
+
+    /*
+     cutEdges:
+     Pre-condition: part holds a part for every vertex of graph.
+     Post-condition: The number of edges whose ends are in different parts is returned.
+     */
+    static long long cutEdges(const CSRGraph& graph, const vector<int>& part);
+
+private:
+    /*
+     Level: one graph of the coarsening, undirected and numbered from 0.
+     The neighbours of v are adjncy[xadj[v]] up to adjncy[xadj[v + 1]].
+     */
+    struct Level
+    {
+        vector<int> xadj;                         // first neighbour of each vertex
+
+        vector<int> adjncy;                       // neighbours
+
+        vector<int> adjwgt;                       // edges merged into each neighbour
+
+        vector<int> vwgt;                         // vertices merged into each vertex
+
+        vector<int> cmap;                         // vertex of the next coarser level
+    };
+
+    /*
+     coarsen:
+     Pre-condition: fine is a level.
+     Post-condition: fine.cmap maps each vertex to a vertex of coarse, which holds fine with matched pairs merged.
+     */
+    static void coarsen(Level& fine, Level& coarse);
+
+    /*
+     growParts:
+     Pre-condition: graph is the coarsest level.
+     Post-condition: part holds an initial split of graph into parts of about equal weight.
+     */
+    static void growParts(const Level& graph, int parts, vector<int>& part);
+
+    /*
+     refine:
+     Pre-condition: part holds a split of graph.
+                    maxWeight is the most a part may weigh.
+     Post-condition: Boundary vertices were moved until no move reduces the cut or the balance.
+     */
+    static void refine(const Level& graph, int parts, int maxWeight, vector<int>& part);
+};
+
+#endif
@@ -0,0 +1,390 @@
+/*****************************************************************/
+/* graphserver.cpp
+/*
+/* Author: Hans Nicolaus
+/*
+/* This driver file keeps a graph loaded and answers shortest path
+/* and depth-first queries over a local Unix domain socket, so the
+/* graph is built and solved once instead of once per run.
+/*
+/* Usage: graphserver <socket path> <GraphM data file> [GraphL data file]
+/*
+/* Every request is three native 32-bit integers: op, a, b.
+/*   op 1 (POINT):  shortest path from a to b
+/*   op 2 (SOURCE): shortest distances from a to every vertex
+/*   op 3 (DFS):    depth-first ordering from a, or of the whole graph if a is 0
+/* Every response is op, count and then count native 32-bit integers:
+/*   POINT:  the distance followed by the path, count 0 if unreachable
+/*   SOURCE: the distance to vertices 1 to size, the largest int if unreachable
+/*   DFS:    the vertices in depth-first order
+/* A count of -1 means the request was invalid.
+/*
+/* One event loop runs per core. Each loop reads every request that
+/* arrived on its connections during one wakeup and answers all of
+/* them against a single pinned graph version.
+/*
+/*****************************************************************/
+
+#include <iostream>
+#include <fstream>
+#include <thread>
+#include <vector>
+#include <map>
+#include <limits>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/epoll.h>
+#include "graphl.h"
+#include "graphversions.h"
+using namespace std;
+
+const int OP_POINT = 1;           // point-to-point shortest path
+const int OP_SOURCE = 2;          // single-source shortest distances
+const int OP_DFS = 3;             // depth-first ordering
+
+const int REQUESTSIZE = 3 * sizeof(int);
+const int MAXEVENTS = 64;         // events handled per wakeup
+
+/*
+ Connection: the bytes received but not yet answered, and the answer
+ bytes the socket has not accepted yet, for one client.
+ */
+struct Connection
+{
+    string in;                    // partial requests
+
+    string out;                   // unsent responses
+
+    uint32_t watching = EPOLLIN;  // events the loop waits for on the socket
+
+    bool hungUp = false;          // the client has sent its last request
+};
+
+/*
+ Worker: one event loop and the connections it owns.
+ */
+struct Worker
+{
+    int epollFd;                  // epoll instance of this loop
+
+    map<int, Connection> connections;
+};
+
+GraphVersions versions;           // shortest path engine, one version per update
+GraphL listGraph;                 // graph used for depth-first queries
+bool hasListGraph = false;        // whether a GraphL data file was given
+
+/*
+ appendInt:
+ Pre-condition: out is the response being built.
+ Post-condition: value is appended to out as a native 32-bit integer.
+ */
+void appendInt(string& out, int value)
+{
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+/*
+ answer:
+ Pre-condition: graph is the pinned graph version.
+                op, a and b are the fields of one request.
+                path is scratch space reused between requests.
+ Post-condition: The response to the request is appended to out.
+ */
+void answer(const GraphM& graph, int op, int a, int b, vector<int>& path, string& out)
+{
+    appendInt(out, op);
+
+    if(op == OP_POINT && a >= 1 && a <= graph.getSize() && b >= 1 && b <= graph.getSize())
+    {
+        path.clear();
+        for(GraphM::PathIterator it = graph.pathBegin(a, b); it != graph.pathEnd(); ++it)
+        {
+            path.push_back(*it);
+        }
+
+        if(path.empty())
+        {
+            appendInt(out, 0);
+            return;
+        }
+
+        appendInt(out, path.size() + 1);
+        appendInt(out, graph.getDistance(a, b));
+        // the iterator walks from b back to a
+        for(int i = path.size() - 1; i >= 0; i--)
+        {
+            appendInt(out, path[i]);
+        }
+    }
+    else if(op == OP_SOURCE && a >= 1 && a <= graph.getSize())
+    {
+        appendInt(out, graph.getSize());
+        for(int dest = 1; dest <= graph.getSize(); dest++)
+        {
+            appendInt(out, graph.getDistance(a, dest));
+        }
+    }
+    else if(op == OP_DFS && hasListGraph && a >= 0 && a <= listGraph.getSize())
+    {
+        listGraph.depthFirstOrder(a, path);
+        appendInt(out, path.size());
+        for(int i = 0; i < (int)path.size(); i++)
+        {
+            appendInt(out, path[i]);
+        }
+    }
+    else
+    {
+        appendInt(out, -1);
+    }
+}
+
+/*
+ flushConnection:
+ Pre-condition: fd is a connection of worker.
+ Post-condition: As much of the pending output as the socket accepts is written. The loop is told to wait for the socket to become writable if output remains, and to stop reading once the client has hung up. Output the client can no longer receive is dropped.
+ */
+void flushConnection(Worker& worker, int fd, Connection& conn)
+{
+    size_t sent = 0;
+    bool failed = false;
+    while(sent < conn.out.size())
+    {
+        ssize_t n = write(fd, conn.out.data() + sent, conn.out.size() - sent);
+        if(n <= 0)
+        {
+            failed = n < 0 && errno != EAGAIN && errno != EWOULDBLOCK;
+            break;
+        }
+        sent += n;
+    }
+    conn.out.erase(0, sent);
+    if(failed)
+    {
+        conn.out.clear();
+    }
+
+    // the registration only changes when the socket fills up, drains or is hung up on
+    uint32_t watching = (conn.hungUp ? 0u : (uint32_t)EPOLLIN) | (conn.out.empty() ? 0u : (uint32_t)EPOLLOUT);
+    if(conn.watching != watching)
+    {
+        conn.watching = watching;
+
+        epoll_event event;
+        event.events = watching;
+        event.data.fd = fd;
+        epoll_ctl(worker.epollFd, EPOLL_CTL_MOD, fd, &event);
+    }
+}
+
+/*
+ closeConnection:
+ Pre-condition: fd is a connection of worker.
+ Post-condition: The socket is closed and its state is discarded.
+ */
+void closeConnection(Worker& worker, int fd)
+{
+    epoll_ctl(worker.epollFd, EPOLL_CTL_DEL, fd, NULL);
+    close(fd);
+    worker.connections.erase(fd);
+}
+
+/*
+ runWorker:
+ Pre-condition: worker has an epoll instance that the acceptor adds connections to.
+ Post-condition: Requests on the connections of worker are answered until the process exits.
+ */
+void runWorker(Worker& worker)
+{
+    int reader = versions.registerReader();
+    epoll_event events[MAXEVENTS];
+    vector<int> ready;            // connections with complete requests this wakeup
+    vector<int> path;
+    char chunk[65536];
+
+    for(;;)
+    {
+        int count = epoll_wait(worker.epollFd, events, MAXEVENTS, -1);
+        ready.clear();
+
+        for(int i = 0; i < count; i++)
+        {
+            int fd = events[i].data.fd;
+            Connection& conn = worker.connections[fd];
+
+            if(events[i].events & EPOLLOUT)
+            {
+                flushConnection(worker, fd, conn);
+                if(conn.hungUp && conn.out.empty())
+                {
+                    closeConnection(worker, fd);
+                    continue;
+                }
+            }
+
+            if(!conn.hungUp && (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)))
+            {
+                bool open = true;
+                for(;;)
+                {
+                    ssize_t n = read(fd, chunk, sizeof(chunk));
+                    if(n > 0)
+                    {
+                        conn.in.append(chunk, n);
+                    }
+                    else if(n < 0 && errno == EINTR)
+                    {
+                        // a signal interrupted the read, the connection is fine
+                        continue;
+                    }
+                    else
+                    {
+                        // end of file still leaves the requests already read to answer
+                        conn.hungUp = n == 0;
+                        open = n == 0 || errno == EAGAIN || errno == EWOULDBLOCK;
+                        break;
+                    }
+                }
+
+                if(!open)
+                {
+                    closeConnection(worker, fd);
+                }
+                else if((int)conn.in.size() >= REQUESTSIZE)
+                {
+                    ready.push_back(fd);
+                }
+                else if(conn.hungUp && conn.out.empty())
+                {
+                    closeConnection(worker, fd);
+                }
+                else if(conn.hungUp)
+                {
+                    flushConnection(worker, fd, conn);
+                }
+            }
+        }
+
+        if(ready.empty())
+        {
+            continue;
+        }
+
+        // every request of this wakeup is answered from the same version
+        {
+            GraphVersions::ReadGuard graph(versions, reader);
+            for(int i = 0; i < (int)ready.size(); i++)
+            {
+                Connection& conn = worker.connections[ready[i]];
+                size_t offset = 0;
+                while(conn.in.size() - offset >= (size_t)REQUESTSIZE)
+                {
+                    int request[3];
+                    memcpy(request, conn.in.data() + offset, REQUESTSIZE);
+                    answer(*graph, request[0], request[1], request[2], path, conn.out);
+                    offset += REQUESTSIZE;
+                }
+                conn.in.erase(0, offset);
+            }
+        }
+
+        for(int i = 0; i < (int)ready.size(); i++)
+        {
+            Connection& conn = worker.connections[ready[i]];
+            flushConnection(worker, ready[i], conn);
+            if(conn.hungUp && conn.out.empty())
+            {
+                closeConnection(worker, ready[i]);
+            }
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    if(argc < 3)
+    {
+        cout << "Usage: graphserver <socket path> <GraphM data file> [GraphL data file]" << endl;
+        return 1;
+    }
+
+    ifstream infile1(argv[2]);
+    if(!infile1)
+    {
+        cout << "File could not be opened." << endl;
+        return 1;
+    }
+    versions.load(infile1);
+
+    if(argc > 3)
+    {
+        ifstream infile2(argv[3]);
+        if(!infile2)
+        {
+            cout << "File could not be opened." << endl;
+            return 1;
+        }
+        listGraph.buildGraph(infile2);
+        hasListGraph = true;
+    }
+
+    // a client hanging up mid-write must not end the server
+    signal(SIGPIPE, SIG_IGN);
+
+    int listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, argv[1], sizeof(address.sun_path) - 1);
+    unlink(argv[1]);
+
+    if(listenFd < 0 || bind(listenFd, (sockaddr*)&address, sizeof(address)) < 0 || listen(listenFd, SOMAXCONN) < 0)
+    {
+        cout << "Socket could not be opened: " << strerror(errno) << endl;
+        return 1;
+    }
+
+    int threads = thread::hardware_concurrency();
+    if(threads < 1)
+    {
+        threads = 1;
+    }
+    else if(threads > GraphVersions::MAXREADERS)
+    {
+        threads = GraphVersions::MAXREADERS;
+    }
+
+    vector<Worker> workers(threads);
+    vector<thread> loops;
+    for(int i = 0; i < threads; i++)
+    {
+        workers[i].epollFd = epoll_create1(0);
+        loops.push_back(thread(runWorker, ref(workers[i])));
+    }
+
+    cout << "Serving " << argv[2] << " on " << argv[1] << " with " << threads << " threads." << endl;
+
+    // connections are dealt to the loops in turn
+    for(int next = 0; ; next = (next + 1) % threads)
+    {
+        int fd = accept(listenFd, NULL, NULL);
+        if(fd < 0)
+        {
+            continue;
+        }
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+        epoll_event event;
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        epoll_ctl(workers[next].epollFd, EPOLL_CTL_ADD, fd, &event);
+    }
+
+    return 0;
+}
@@ -0,0 +1,235 @@
+/*****************************************************************/
+/* GraphVersions.cpp
+/*
+/* Author: Hans Nicolaus
+/*
+/* This file contains the implementations of the constructors and
+/* methods which interfaces are defined in the GraphVersions.h file
+/*
+/*****************************************************************/
+
+#include "graphversions.h"
+#include <limits>
+
+/*
+ Default constructor:
+ Pre-condition: Sufficient memory is available.
+ Post-condition: An empty graph is published as the first version and no reader is registered.
+ */
+GraphVersions::GraphVersions() : current(new GraphM()), globalEpoch(1)
+{
+    for(int i = 0; i < MAXREADERS; i++)
+    {
+        readerEpoch[i].store(0);
+        slotUsed[i].store(false);
+    }
+}
+
+/*
+ ~GraphVersions:
+ Pre-condition: No reader still holds a ReadGuard.
+ Post-condition: The current version and all retired versions are deallocated.
+ */
+GraphVersions::~GraphVersions()
+{
+    delete current.load();
+
+    for(int i = 0; i < (int)retired.size(); i++)
+    {
+        delete retired[i].first;
+    }
+}
+
+/*
+ load:
+ Pre-condition: The file associated with the input stream exists.
+                input is the input stream that allows working with the text file.
+ Post-condition: A graph is built from the next graph in the file, its shortest paths are computed, and it is published as the current version.
+ */
+void GraphVersions::load(ifstream& input)
+{
+    GraphM* next = new GraphM();
+    PERF_COUNT(BYTES_ALLOCATED, sizeof(GraphM));
+    next->buildGraph(input);
+    next->findShortestPath();
+
+    lock_guard<mutex> lock(writerLock);
+    publish(next);
+}
+
+/*
+ insertEdge:
+ Pre-condition: The source and destination vertex, and their weight are valid.
+ Post-condition: A new version with the edge inserted and its shortest paths recomputed is published. Readers keep their old version until they read again.
+ */
+void GraphVersions::insertEdge(int source, int dest, int weight)
+{
+    EdgeUpdate update = { source, dest, weight };
+    applyUpdates(vector<EdgeUpdate>(1, update));
+}
+
+/*
+ removeEdge:
+ Pre-condition: The source and destination vertex are valid.
+ Post-condition: A new version with the edge removed and its shortest paths recomputed is published. Readers keep their old version until they read again.
+ */
+void GraphVersions::removeEdge(int source, int dest)
+{
+    EdgeUpdate update = { source, dest, std::numeric_limits<int>::max() };
+    applyUpdates(vector<EdgeUpdate>(1, update));
+}
+
+/*
+ applyUpdates:
+ Pre-condition: updates are the edge changes to be made together.
+ Post-condition: One new version containing all the changes is published, so readers never see only some of them and the shortest paths are recomputed once.
+ */
+void GraphVersions::applyUpdates(const vector<EdgeUpdate>& updates)
+{
+    lock_guard<mutex> lock(writerLock);
+
+    // the current version is never written to, the changes go into a copy
+    GraphM* next = new GraphM(*current.load());
+    PERF_COUNT(BYTES_ALLOCATED, sizeof(GraphM));
+    for(int i = 0; i < (int)updates.size(); i++)
+    {
+        if(updates[i].weight == std::numeric_limits<int>::max())
+        {
+            next->removeEdge(updates[i].source, updates[i].dest);
+        }
+        else
+        {
+            next->insertEdge(updates[i].source, updates[i].dest, updates[i].weight);
+        }
+    }
+    next->findShortestPath();
+
+    publish(next);
+}
+
+/*
+ registerReader:
+ Pre-condition: None.
+ Post-condition: A free reader slot is claimed and returned, or -1 is returned if all MAXREADERS slots are in use.
+ */
+int GraphVersions::registerReader()
+{
+    for(int i = 0; i < MAXREADERS; i++)
+    {
+        bool expected = false;
+        if(slotUsed[i].compare_exchange_strong(expected, true))
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/*
+ unregisterReader:
+ Pre-condition: reader is a slot returned by registerReader that holds no ReadGuard.
+ Post-condition: The slot is free for another thread.
+ */
+void GraphVersions::unregisterReader(int reader)
+{
+    readerEpoch[reader].store(0);
+    slotUsed[reader].store(false);
+}
+
+/*
+ publish:
+ Pre-condition: The writer lock is held.
+                next is a complete version that no reader has seen.
+ Post-condition: next becomes the current version, the old version is retired, and every retired version no reader can still see is deallocated.
+ */
+void GraphVersions::publish(GraphM* next)
+{
+    GraphM* old = current.exchange(next);
+
+    // a reader that announced this epoch or an earlier one may still hold old,
+    // every later reader loaded current after the exchange and holds next
+    unsigned long epoch = globalEpoch.fetch_add(1);
+    retired.push_back(make_pair(old, epoch));
+
+    unsigned long oldestActive = std::numeric_limits<unsigned long>::max();
+    for(int i = 0; i < MAXREADERS; i++)
+    {
+        unsigned long announced = readerEpoch[i].load();
+        if(announced != 0 && announced < oldestActive)
+        {
+            oldestActive = announced;
+        }
+    }
+
+    int kept = 0;
+    for(int i = 0; i < (int)retired.size(); i++)
+    {
+        if(retired[i].second < oldestActive)
+        {
+            delete retired[i].first;
+        }
+        else
+        {
+            retired[kept] = retired[i];
+            kept++;
+        }
+    }
+    retired.resize(kept);
+}
+
+/*
+ enter:
+ Pre-condition: reader is a registered slot that holds no ReadGuard.
+ Post-condition: The current epoch is announced in the slot and the current version is returned.
+ */
+const GraphM* GraphVersions::enter(int reader)
+{
+    // the epoch must be visible before current is read, both are sequentially consistent
+    readerEpoch[reader].store(globalEpoch.load());
+    return current.load();
+}
+
+/*
+ leave:
+ Pre-condition: reader is a slot that was entered.
+ Post-condition: The slot no longer keeps any version alive.
+ */
+void GraphVersions::leave(int reader)
+{
+    readerEpoch[reader].store(0);
+}
+
+/*
+ ReadGuard constructor:
+ Pre-condition: reader is a registered slot of versions that holds no ReadGuard.
+ Post-condition: The current version is pinned until the guard goes out of scope.
+ */
+GraphVersions::ReadGuard::ReadGuard(GraphVersions& versions, int reader) : versions(versions), reader(reader)
+{
+    graph = versions.enter(reader);
+}
+
+/*
+ ~ReadGuard:
+ Pre-condition: The guard is going out of scope.
+ Post-condition: The pinned version may be deallocated by a later publish.
+ */
+GraphVersions::ReadGuard::~ReadGuard()
+{
+    versions.leave(reader);
+}
+
+/*
+ operator*, operator->:
+ Pre-condition: The guard is in scope.
+ Post-condition: The pinned version is returned.
+ */
+const GraphM& GraphVersions::ReadGuard::operator*() const
+{
+    return *graph;
+}
+
+const GraphM* GraphVersions::ReadGuard::operator->() const
+{
+    return graph;
+}
@@ -0,0 +1,169 @@
+/*****************************************************************/
+/* GraphVersions.h
+/*
+/* Author: Hans Nicolaus
+/*
+/* This header file contains the interfaces of method implementations
+/* of the GraphVersions class, which hides the implementations
+/* of all methods that are implemented in the GraphVersions.cpp file.
+/*
+/* GraphVersions lets many threads query a GraphM while edges are
+/* being changed. Every change builds a new GraphM with its shortest
+/* path matrix already computed and publishes it with one atomic
+/* pointer swap. Readers never lock: they announce the epoch they read
+/* in, and an old version is deleted only after no reader that could
+/* still be using it remains.
+/*
+/*****************************************************************/
+
+#ifndef GRAPHVERSIONS_H
+#define GRAPHVERSIONS_H
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <fstream>
+#include "graphm.h"
+using namespace std;
+
+class GraphVersions
+{
+public:
+    const static int MAXREADERS = 64;     // reader threads that may be registered at once
+
+    /*
+     EdgeUpdate: one change to the adjacency matrix. A weight of the
+     largest int removes the edge.
+     */
+    struct EdgeUpdate
+    {
+        int source;            // vertex where the edge starts from
+
+        int dest;              // vertex where the edge ends at
+
+        int weight;            // new distance, or the largest int to remove
+    };
+
+    /*
+     ReadGuard: pins the version that was current when it was created.
+     The version stays valid, and never changes, until the guard goes
+     out of scope.
+     */
+    class ReadGuard
+    {
+    public:
+        ReadGuard(GraphVersions& versions, int reader);
+
+        ~ReadGuard();
+
+        const GraphM& operator*() const;
+
+        const GraphM* operator->() const;
+
+    private:
+        ReadGuard(const ReadGuard&);              // a guard cannot be copied
+        ReadGuard& operator=(const ReadGuard&);
+
+        GraphVersions& versions;   // owner of the pinned version
+
+        int reader;                // slot the epoch is announced in
+
+        const GraphM* graph;       // the pinned version
+    };
+
+    /*
+     Default constructor:
+     Pre-condition: Sufficient memory is available.
+     Post-condition: An empty graph is published as the first version and no reader is registered.
+     */
+    GraphVersions();
+
+    /*
+     ~GraphVersions:
+     Pre-condition: No reader still holds a ReadGuard.
+     Post-condition: The current version and all retired versions are deallocated.
+     */
+    ~GraphVersions();
+
+    /*
+     load:
+     Pre-condition: The file associated with the input stream exists.
+                    input is the input stream that allows working with the text file.
+     Post-condition: A graph is built from the next graph in the file, its shortest paths are computed, and it is published as the current version.
+     */
+    void load(ifstream& input);
+
+    /*
+     insertEdge:
+     Pre-condition: The source and destination vertex, and their weight are valid.
+     Post-condition: A new version with the edge inserted and its shortest paths recomputed is published. Readers keep their old version until they read again.
+     */
+    void insertEdge(int source, int dest, int weight);
+
+    /*
+     removeEdge:
+     Pre-condition: The source and destination vertex are valid.
+     Post-condition: A new version with the edge removed and its shortest paths recomputed is published. Readers keep their old version until they read again.
+     */
+    void removeEdge(int source, int dest);
+
+    /*
+     applyUpdates:
+     Pre-condition: updates are the edge changes to be made together.
+     Post-condition: One new version containing all the changes is published, so readers never see only some of them and the shortest paths are recomputed once.
+     */
+    void applyUpdates(const vector<EdgeUpdate>& updates);
+
+    /*
+     registerReader:
+     Pre-condition: None.
+     Post-condition: A free reader slot is claimed and returned, or -1 is returned if all MAXREADERS slots are in use.
+     */
+    int registerReader();
+
+    /*
+     unregisterReader:
+     Pre-condition: reader is a slot returned by registerReader that holds no ReadGuard.
+     Post-condition: The slot is free for another thread.
+     */
+    void unregisterReader(int reader);
+
+private:
+    GraphVersions(const GraphVersions&);          // versions cannot be copied
+    GraphVersions& operator=(const GraphVersions&);
+
+    /*
+     publish:
+     Pre-condition: The writer lock is held.
+                    next is a complete version that no reader has seen.
+     Post-condition: next becomes the current version, the old version is retired, and every retired version no reader can still see is deallocated.
+     */
+    void publish(GraphM* next);
+
+    /*
+     enter:
+     Pre-condition: reader is a registered slot that holds no ReadGuard.
+     Post-condition: The current epoch is announced in the slot and the current version is returned.
+     */
+    const GraphM* enter(int reader);
+
+    /*
+     leave:
+     Pre-condition: reader is a slot that was entered.
+     Post-condition: The slot no longer keeps any version alive.
+     */
+    void leave(int reader);
+
+    atomic<GraphM*> current;                      // version new readers get
+
+    atomic<unsigned long> globalEpoch;            // advanced by every publish
+
+    atomic<unsigned long> readerEpoch[MAXREADERS];  // epoch read in, 0 when idle
+
+    atomic<bool> slotUsed[MAXREADERS];            // whether a reader owns the slot
+
+    mutex writerLock;                             // writers take turns
+
+    vector< pair<GraphM*, unsigned long> > retired;  // old versions, epoch retired in
+};
+
+#endif
@@ -0,0 +1,620 @@
+/*****************************************************************/
+/* labcheck.cpp
+/*
+/* Author: Hans Nicolaus
+/*
+/* This driver file checks the newer graph methods against plain
+/* GraphM and GraphL, the way lab3.cpp exercises the originals. Every
+/* graph of the GraphM data files is solved with findShortestPath, and
+/* the newer methods must agree with it. Every graph of the GraphL data
+/* file is searched with depthFirstOrder, and the newer methods must
+/* agree with that. Each method has a check function of its own, and
+/* one line is printed per check and graph.
+/*
+/* Usage: labcheck [GraphM data file] [GraphL data file]
+/* The files default to data32.txt for GraphL, and to data31.txt and
+/* then dataUWB.txt for GraphM. The exit status is the number of failed
+/* checks.
+/*
+/*****************************************************************/
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <limits>
+#include <algorithm>
+#include <queue>
+#include <cstdio>
+#include "graphm.h"
+#include "graphl.h"
+#include "csrgraph.h"
+#include "csrbuilder.h"
+#include "externalgraph.h"
+#include "graphpartitioner.h"
+#include "partitionedsearch.h"
+#include "asyncquery.h"
+using namespace std;
+
+const char* SCRATCHFILE = "labcheck.csr";   // where graphs are saved for ExternalGraph
+const int BLOCKVERTICES = 2;                // small blocks, so searches go through the cache
+const long long MEMORYLIMIT = 64;           // a few blocks at most, so blocks are dropped and read again
+const int PARTS = 2;                        // parts for PartitionedSearch
+const int K = 3;                            // paths asked of kShortestPaths
+
+int failures = 0;                           // checks that did not pass
+
+/*
+ check:
+ Pre-condition: number is the graph being checked, from 1.
+                what names the check.
+ Post-condition: The outcome is printed, and counted if the check failed.
+ */
+void check(int number, const string& what, bool passed)
+{
+    cout << "Graph " << number << ": " << what << (passed ? " passed" : " FAILED") << endl;
+    if(!passed)
+    {
+        failures++;
+    }
+}
+
+/*
+ sameDistances:
+ Pre-condition: G is solved.
+                dist holds distances from source for vertices 1 to G.getSize(), and the largest int for unreachable ones.
+ Post-condition: Returns true if every distance matches G.
+ */
+bool sameDistances(const GraphM& G, int source, const vector<int>& dist)
+{
+    if((int)dist.size() < G.getSize() + 1)
+    {
+        return false;
+    }
+    for(int v = 1; v <= G.getSize(); v++)
+    {
+        if(dist[v] != G.getDistance(source, v))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ sameEdges:
+ Pre-condition: a and b are graphs.
+                ordered is true if the edges of each vertex have to be in the same order.
+ Post-condition: Returns true if they have the same vertices and every vertex has the same edges with the same weights.
+ */
+bool sameEdges(const CSRGraph& a, const CSRGraph& b, bool ordered)
+{
+    if(a.getVertexCount() != b.getVertexCount())
+    {
+        return false;
+    }
+
+    vector<pair<int, int> > edgesA;
+    vector<pair<int, int> > edgesB;
+    for(int v = 1; v <= a.getVertexCount(); v++)
+    {
+        edgesA.clear();
+        edgesB.clear();
+        for(long long e = a.edgeBegin(v); e < a.edgeEnd(v); e++)
+        {
+            edgesA.push_back(pair<int, int>(a.getTarget(e), a.getWeight(e)));
+        }
+        for(long long e = b.edgeBegin(v); e < b.edgeEnd(v); e++)
+        {
+            edgesB.push_back(pair<int, int>(b.getTarget(e), b.getWeight(e)));
+        }
+        if(!ordered)
+        {
+            sort(edgesA.begin(), edgesA.end());
+            sort(edgesB.begin(), edgesB.end());
+        }
+        if(edgesA != edgesB)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ breadthFirstLevels:
+ Pre-condition: csr is a graph.
+ Post-condition: level[v] holds the number of edges from source to v, or the largest int if v cannot be reached.
+ */
+void breadthFirstLevels(const CSRGraph& csr, int source, vector<int>& level)
+{
+    level.assign(csr.getVertexCount() + 1, numeric_limits<int>::max());
+    queue<int> next;
+    level[source] = 0;
+    next.push(source);
+    while(!next.empty())
+    {
+        int v = next.front();
+        next.pop();
+        for(long long e = csr.edgeBegin(v); e < csr.edgeEnd(v); e++)
+        {
+            if(level[csr.getTarget(e)] == numeric_limits<int>::max())
+            {
+                level[csr.getTarget(e)] = level[v] + 1;
+                next.push(csr.getTarget(e));
+            }
+        }
+    }
+}
+
+/*
+ checkShortestPaths:
+ Pre-condition: G is solved and csr holds its edges.
+ Post-condition: The outcome of comparing every distance of G with Floyd-Warshall over csr is printed. On the UWB graph, findV once settled a visited vertex again when it tied for the smallest distance, and reported reachable vertices such as 2 and 5 from 1 as unreachable.
+ */
+void checkShortestPaths(int number, const GraphM& G, const CSRGraph& csr)
+{
+    // sums are taken in 64 bits, so two unreachable legs never add up to a shorter path
+    int n = G.getSize();
+    vector< vector<long long> > dist(n + 1, vector<long long>(n + 1, numeric_limits<int>::max()));
+    for(int v = 1; v <= n; v++)
+    {
+        dist[v][v] = 0;
+        for(long long e = csr.edgeBegin(v); e < csr.edgeEnd(v); e++)
+        {
+            dist[v][csr.getTarget(e)] = min(dist[v][csr.getTarget(e)], (long long)csr.getWeight(e));
+        }
+    }
+    for(int via = 1; via <= n; via++)
+    {
+        for(int source = 1; source <= n; source++)
+        {
+            for(int dest = 1; dest <= n; dest++)
+            {
+                dist[source][dest] = min(dist[source][dest], dist[source][via] + dist[via][dest]);
+            }
+        }
+    }
+
+    bool same = true;
+    for(int source = 1; source <= n && same; source++)
+    {
+        for(int dest = 1; dest <= n && same; dest++)
+        {
+            same = dist[source][dest] == G.getDistance(source, dest);
+        }
+    }
+    check(number, "findShortestPath", same);
+}
+
+/*
+ checkDistanceTable:
+ Pre-condition: G is solved.
+ Post-condition: The outcome of comparing distanceTable over every vertex, and over 0 and size + 1 which must come back unreachable, with getDistance is printed.
+ */
+void checkDistanceTable(int number, GraphM& G)
+{
+    vector<int> all;
+    for(int v = 0; v <= G.getSize() + 1; v++)
+    {
+        all.push_back(v);
+    }
+    vector<int> table(all.size() * all.size());
+    G.distanceTable(all, all, table.data());
+
+    bool same = true;
+    for(int i = 0; i < (int)all.size(); i++)
+    {
+        for(int j = 0; j < (int)all.size(); j++)
+        {
+            same = same && table[i * all.size() + j] == G.getDistance(all[i], all[j]);
+        }
+    }
+    check(number, "distanceTable", same);
+}
+
+/*
+ checkKShortest:
+ Pre-condition: G is solved.
+ Post-condition: The outcome is printed of checking that, for every pair of vertices, kShortestPaths gives loopless paths from source to dest of rising cost, starting with the shortest distance of G, or none if dest cannot be reached.
+ */
+void checkKShortest(int number, GraphM& G)
+{
+    vector< vector<int> > paths;
+    vector<int> costs;
+    bool same = true;
+    for(int source = 1; source <= G.getSize() && same; source++)
+    {
+        for(int dest = 1; dest <= G.getSize() && same; dest++)
+        {
+            int found = G.kShortestPaths(source, dest, K, paths, costs);
+            bool reachable = source != dest && G.getDistance(source, dest) != numeric_limits<int>::max();
+            if(!reachable)
+            {
+                same = found == 0;
+                continue;
+            }
+            same = found >= 1 && found <= K && costs[0] == G.getDistance(source, dest);
+
+            for(int p = 0; p < found && same; p++)
+            {
+                vector<int> sorted(paths[p]);
+                sort(sorted.begin(), sorted.end());
+                bool loopless = unique(sorted.begin(), sorted.end()) == sorted.end();
+                same = loopless && paths[p].front() == source && paths[p].back() == dest && (p == 0 || costs[p] >= costs[p - 1]);
+            }
+        }
+    }
+    check(number, "kShortestPaths", same);
+}
+
+/*
+ checkReordering:
+ Pre-condition: G is solved.
+ Post-condition: The outcome is printed of checking that a copy of G renumbered by every ordering finds the same distances, paths and k shortest paths.
+ */
+void checkReordering(int number, GraphM& G)
+{
+    VertexOrder::Ordering orderings[] = { VertexOrder::RCM, VertexOrder::BFS, VertexOrder::DEGREE };
+    vector< vector<int> > paths;
+    vector< vector<int> > reorderedPaths;
+    vector<int> costs;
+    vector<int> reorderedCosts;
+
+    bool same = true;
+    for(int o = 0; o < 3 && same; o++)
+    {
+        GraphM* reordered = new GraphM(G);
+        reordered->reorderVertices(orderings[o]);
+        reordered->findShortestPath();
+
+        for(int source = 1; source <= G.getSize() && same; source++)
+        {
+            for(int dest = 1; dest <= G.getSize() && same; dest++)
+            {
+                G.kShortestPaths(source, dest, K, paths, costs);
+                reordered->kShortestPaths(source, dest, K, reorderedPaths, reorderedCosts);
+                same = reordered->getDistance(source, dest) == G.getDistance(source, dest) && reorderedPaths == paths && reorderedCosts == costs;
+            }
+        }
+        delete reordered;
+    }
+    check(number, "reorderVertices", same);
+}
+
+/*
+ checkListReordering:
+ Pre-condition: G and reordered are built from the same graph of the GraphL data file, reordered not yet changed.
+ Post-condition: The outcome is printed of checking that reordered, renumbered by reverse Cuthill-McKee, gives the depth-first order of G from every start.
+ */
+void checkListReordering(int number, GraphL& G, GraphL& reordered)
+{
+    vector<int> expected;
+    vector<int> ordering;
+    reordered.reorderVertices(VertexOrder::RCM);
+
+    bool same = true;
+    for(int start = 0; start <= G.getSize() && same; start++)
+    {
+        G.depthFirstOrder(start, expected);
+        reordered.depthFirstOrder(start, ordering);
+        same = ordering == expected;
+    }
+    check(number, "GraphL reorderVertices", same);
+}
+
+/*
+ readNames:
+ Pre-condition: input is positioned at the start of a graph in the GraphM text file format.
+ Post-condition: names holds the vertex descriptions of the graph, and input is positioned after its edge section. Returns false if no graph was left in the file.
+ */
+bool readNames(ifstream& input, vector<string>& names)
+{
+    int size = 0;
+    if(!(input >> size))
+    {
+        return false;
+    }
+
+    // move the cursor to the next line, ignoring \n character after the last >>
+    string discardEndline;
+    getline(input, discardEndline);
+
+    names.resize(size);
+    for(int i = 0; i < size; i++)
+    {
+        getline(input, names[i]);
+    }
+
+    int source = 0;
+    int dest = 0;
+    int dist = 0;
+    while(input >> source >> dest >> dist && (source != 0 || dest != 0 || dist != 0))
+    {
+    }
+    getline(input, discardEndline);
+    return true;
+}
+
+/*
+ checkFindVertex:
+ Pre-condition: G is built from the GraphM data file.
+                names holds the vertex descriptions of the same graph, read from the file.
+ Post-condition: The outcome is printed of checking that findVertex finds every description, and nothing for a description that is not there.
+ */
+void checkFindVertex(int number, const GraphM& G, const vector<string>& names)
+{
+    bool same = (int)names.size() == G.getSize();
+    for(int v = 1; v <= G.getSize() && same; v++)
+    {
+        // the first vertex of a description wins, so a repeated one maps to an earlier vertex
+        int found = G.findVertex(names[v - 1]);
+        same = found >= 1 && found <= v && names[found - 1] == names[v - 1];
+    }
+    check(number, "findVertex", same && G.findVertex("no such vertex") == 0);
+}
+
+/*
+ checkCompressEdges:
+ Pre-condition: G and compressed are built from the same graph of the GraphL data file, compressed not yet changed.
+ Post-condition: The outcome is printed of checking that compressed, once its edges are compressed, gives the depth-first order of G from every start.
+ */
+void checkCompressEdges(int number, GraphL& G, GraphL& compressed)
+{
+    vector<int> expected;
+    vector<int> ordering;
+    compressed.compressEdges();
+
+    bool same = true;
+    for(int start = 0; start <= G.getSize() && same; start++)
+    {
+        G.depthFirstOrder(start, expected);
+        compressed.depthFirstOrder(start, ordering);
+        same = ordering == expected;
+    }
+    check(number, "compressEdges", same);
+}
+
+/*
+ checkExternal:
+ Pre-condition: G is solved and csr holds its edges.
+ Post-condition: The outcome is printed of checking that ExternalGraph, reading csr back from a file through a cache of a few blocks, finds the distances of G from every source.
+ */
+void checkExternal(int number, const GraphM& G, const CSRGraph& csr)
+{
+    ExternalGraph external;
+    vector<int> dist;
+    vector<int> path;
+    bool same = csr.save(SCRATCHFILE, BLOCKVERTICES) && external.open(SCRATCHFILE, MEMORYLIMIT);
+    for(int source = 1; source <= G.getSize() && same; source++)
+    {
+        same = external.shortestPaths(source, dist, path) && sameDistances(G, source, dist);
+    }
+    check(number, "ExternalGraph", same);
+}
+
+/*
+ checkExternalLevels:
+ Pre-condition: csr holds the edges of a graph of the GraphL data file in list order.
+ Post-condition: The outcome is printed of checking that ExternalGraph breadthFirst gives the levels of a plain queue over csr from every source.
+ */
+void checkExternalLevels(int number, const CSRGraph& csr)
+{
+    ExternalGraph external;
+    vector<int> level;
+    vector<int> externalLevel;
+    bool same = csr.save(SCRATCHFILE, BLOCKVERTICES) && external.open(SCRATCHFILE, MEMORYLIMIT);
+    for(int source = 1; source <= csr.getVertexCount() && same; source++)
+    {
+        breadthFirstLevels(csr, source, level);
+        same = external.breadthFirst(source, externalLevel) && externalLevel == level;
+    }
+    check(number, "ExternalGraph breadthFirst", same);
+}
+
+/*
+ checkPartitioned:
+ Pre-condition: G is solved and csr holds its edges.
+ Post-condition: The outcome is printed of checking that PartitionedSearch, over PARTS parts, finds the distances of G from every source.
+ */
+void checkPartitioned(int number, const GraphM& G, const CSRGraph& csr)
+{
+    vector<int> part;
+    GraphPartitioner::partition(csr, PARTS, part);
+    PartitionedSearch partitioned(csr, part, PARTS);
+    vector<int> dist;
+    vector<int> path;
+
+    bool same = true;
+    for(int source = 1; source <= G.getSize() && same; source++)
+    {
+        partitioned.shortestPaths(source, dist, path);
+        same = sameDistances(G, source, dist);
+    }
+    check(number, "PartitionedSearch", same);
+}
+
+/*
+ checkPartitionedLevels:
+ Pre-condition: csr holds the edges of a graph of the GraphL data file in list order.
+ Post-condition: The outcome is printed of checking that PartitionedSearch breadthFirst gives the levels of a plain queue over csr from every source.
+ */
+void checkPartitionedLevels(int number, const CSRGraph& csr)
+{
+    vector<int> part;
+    GraphPartitioner::partition(csr, PARTS, part);
+    PartitionedSearch partitioned(csr, part, PARTS);
+    vector<int> level;
+    vector<int> partitionedLevel;
+
+    bool same = true;
+    for(int source = 1; source <= csr.getVertexCount() && same; source++)
+    {
+        breadthFirstLevels(csr, source, level);
+        partitioned.breadthFirst(source, partitionedLevel);
+        same = partitionedLevel == level;
+    }
+    check(number, "PartitionedSearch breadthFirst", same);
+}
+
+/*
+ checkAsync:
+ Pre-condition: G is solved and csr holds its edges.
+ Post-condition: The outcome is printed of checking that the shortest path and all pairs queries match G, and that a cancelled query, a query past its deadline, a query from an invalid vertex and a query that would never yield each end with their own status.
+ */
+void checkAsync(int number, const GraphM& G, const CSRGraph& csr, QueryExecutor& executor)
+{
+    AsyncQuery::Options options;
+    options.yieldEvery = 1;       // a yield after every vertex, so the resumption path is exercised
+    int n = G.getSize();
+
+    bool same = true;
+    for(int source = 1; source <= n && same; source++)
+    {
+        AsyncQuery::Result result = AsyncQuery::shortestPaths(executor, csr, source, options).get();
+        same = result.status == AsyncQuery::COMPLETE && sameDistances(G, source, result.values);
+    }
+
+    AsyncQuery::Result all = AsyncQuery::allPairs(executor, csr, options).get();
+    same = same && all.status == AsyncQuery::COMPLETE;
+    for(int source = 1; source <= n && same; source++)
+    {
+        vector<int> row(all.values.begin() + source * (n + 1), all.values.begin() + (source + 1) * (n + 1));
+        same = sameDistances(G, source, row);
+    }
+
+    AsyncQuery::Options cancelled;
+    cancelled.token.cancel();
+    AsyncQuery::Options expired;
+    expired.deadline = chrono::steady_clock::now() - chrono::seconds(1);
+    AsyncQuery::Options neverYields;
+    neverYields.yieldEvery = 0;
+
+    same = same && (n < 1 || (AsyncQuery::shortestPaths(executor, csr, 1, cancelled).get().status == AsyncQuery::CANCELLED
+        && AsyncQuery::allPairs(executor, csr, cancelled).get().status == AsyncQuery::CANCELLED
+        && AsyncQuery::shortestPaths(executor, csr, 1, expired).get().status == AsyncQuery::TIMED_OUT
+        && AsyncQuery::depthFirst(executor, csr, 0, expired).get().status == AsyncQuery::TIMED_OUT
+        && AsyncQuery::shortestPaths(executor, csr, n + 1, options).get().status == AsyncQuery::INVALID
+        && AsyncQuery::shortestPaths(executor, csr, 1, neverYields).get().status == AsyncQuery::INVALID));
+    check(number, "AsyncQuery", same);
+}
+
+/*
+ checkAsyncDepthFirst:
+ Pre-condition: G is built from the GraphL data file and csr holds its edges in list order.
+ Post-condition: The outcome is printed of checking that the depth-first query gives the depth-first order of G.
+ */
+void checkAsyncDepthFirst(int number, const GraphL& G, const CSRGraph& csr, QueryExecutor& executor)
+{
+    vector<int> expected;
+    G.depthFirstOrder(0, expected);
+
+    AsyncQuery::Options options;
+    options.yieldEvery = 1;
+    AsyncQuery::Result result = AsyncQuery::depthFirst(executor, csr, 0, options).get();
+    check(number, "AsyncQuery depthFirst", result.status == AsyncQuery::COMPLETE && result.values == expected);
+}
+
+int main(int argc, char* argv[])
+{
+    // ties at the smallest distance in the UWB graph once made findV settle the wrong vertex
+    vector<string> matrixFiles;
+    if(argc > 1)
+    {
+        matrixFiles.push_back(argv[1]);
+    }
+    else
+    {
+        matrixFiles.push_back("data31.txt");
+        matrixFiles.push_back("dataUWB.txt");
+    }
+    const char* listFile = argc > 2 ? argv[2] : "data32.txt";
+    QueryExecutor executor(2);
+    CSRBuilder builder(2);
+
+    // part 1: graphs are numbered on from one file to the next
+    int number = 1;
+    for(int f = 0; f < (int)matrixFiles.size(); f++)
+    {
+        ifstream infile1(matrixFiles[f].c_str());
+        // the other streams read the same graphs again, for checks that need the text of the file
+        ifstream namesInput(matrixFiles[f].c_str());
+        ifstream builderInput1(matrixFiles[f].c_str());
+        if(!infile1)
+        {
+            cout << "File could not be opened." << endl;
+            return 1;
+        }
+
+        for(; ; number++)
+        {
+            GraphM* G = new GraphM();
+            G->buildGraph(infile1);
+            if(infile1.eof())
+            {
+                delete G;
+                break;
+            }
+            G->findShortestPath();
+            CSRGraph csr;
+            G->toCSR(csr);
+
+            checkShortestPaths(number, *G, csr);
+            checkDistanceTable(number, *G);
+            checkKShortest(number, *G);
+            checkReordering(number, *G);
+            vector<string> names;
+            readNames(namesInput, names);
+            checkFindVertex(number, *G, names);
+            checkExternal(number, *G, csr);
+            checkPartitioned(number, *G, csr);
+            CSRGraph built;
+            vector<string> builtNames;
+            builder.build(builderInput1, true, built, builtNames);
+            check(number, "CSRBuilder", sameEdges(csr, built, false) && builtNames == names);
+            checkAsync(number, *G, csr, executor);
+            delete G;
+        }
+    }
+
+    // part 2: a graph that gets changed is built from a stream of its own
+    ifstream infile2(listFile);
+    ifstream reorderInput(listFile);
+    ifstream compressInput(listFile);
+    ifstream builderInput2(listFile);
+    if(!infile2)
+    {
+        cout << "File could not be opened." << endl;
+        return 1;
+    }
+
+    for(number = 1; ; number++)
+    {
+        GraphL G;
+        G.buildGraph(infile2);
+        if(infile2.eof())
+        {
+            break;
+        }
+        CSRGraph csr;
+        G.toCSR(csr);
+
+        GraphL reordered;
+        reordered.buildGraph(reorderInput);
+        checkListReordering(number, G, reordered);
+        GraphL compressed;
+        compressed.buildGraph(compressInput);
+        checkCompressEdges(number, G, compressed);
+        checkExternalLevels(number, csr);
+        checkPartitionedLevels(number, csr);
+        CSRGraph built;
+        vector<string> names;
+        builder.build(builderInput2, false, built, names);
+        check(number, "GraphL CSRBuilder", sameEdges(csr, built, true));
+        checkAsyncDepthFirst(number, G, csr, executor);
+    }
+
+    remove(SCRATCHFILE);
+    cout << (failures == 0 ? "All checks passed." : "Some checks FAILED.") << endl;
+    return failures;
+}
@@ -0,0 +1,301 @@
+/*****************************************************************/
+/* LabelPool.cpp
+/*
+/* Author: Hans Nicolaus
+/*
+/* This file contains the implementations of the constructors and
+/* methods which interfaces are defined in the LabelPool.h file
+/*
+/*****************************************************************/
+
+#include "labelpool.h"
+#include <algorithm>
+#include <cstring>
+
+/*
+ Default constructor:
+ Pre-condition: Sufficient memory is available.
+ Post-condition: The pool holds only the empty label.
+ */
+LabelPool::LabelPool() : chunkCount(0), chunkCapacity(16), chunkUsed(CHUNKSIZE), blockCapacity(16), nextId(0), table(64, 0), usedSlots(0), liveLabels(0)
+{
+    chunks.store(new char*[chunkCapacity](), memory_order_relaxed);
+    blocks.store(new Block*[blockCapacity](), memory_order_relaxed);
+    intern("");
+}
+
+/*
+ instance:
+ Pre-condition: None.
+ Post-condition: The pool shared by every NodeData is returned. The empty label always has id 0.
+ */
+LabelPool& LabelPool::instance()
+{
+    // never destroyed, as NodeData in static graphs may release labels after main returns
+    static LabelPool* pool = new LabelPool();
+    return *pool;
+}
+
+/*
+ hash:
+ Pre-condition: None.
+ Post-condition: The FNV-1a hash of label is returned.
+ */
+unsigned int LabelPool::hash(string_view label)
+{
+    unsigned int h = 2166136261u;
+    for(size_t i = 0; i < label.size(); i++)
+    {
+        h = (h ^ (unsigned char)label[i]) * 16777619u;
+    }
+    return h;
+}
+
+/*
+ find:
+ Pre-condition: text is the label to be looked up.
+ Post-condition: The id of text is returned, or -1 if it is not in the pool. No reference is taken, so the id is only meaningful while the caller holds one some other way. Unlike view, it takes the lock.
+ */
+int LabelPool::find(string_view text)
+{
+    lock_guard<mutex> guard(lock);
+
+    int slot = slotOf(text);
+    return slot == -1 ? -1 : table[slot] - 1;
+}
+
+/*
+ intern:
+ Pre-condition: text is the label to be stored.
+ Post-condition: The id of text is returned, holding one reference the caller has to release. The text is added to the pool only if it is not there yet.
+ */
+int LabelPool::intern(string_view text)
+{
+    lock_guard<mutex> guard(lock);
+
+    int slot = slotOf(text);
+    if(slot != -1)
+    {
+        retain(table[slot] - 1);
+        return table[slot] - 1;
+    }
+
+    // the table is kept at most half full, removed slots included, so probes stay short
+    if(2 * (usedSlots + 1) > (int)table.size())
+    {
+        rehash();
+    }
+
+    // a released id owning enough of the arena takes the text in place, as nobody can view it any more
+    int id;
+    multimap<int, int>::iterator fit = freeIds.lower_bound(text.size());
+    if(fit != freeIds.end())
+    {
+        id = fit->second;
+        freeIds.erase(fit);
+
+        Block& entry = block(id);
+        long long offset = entry.offset[id % BLOCKSIZE];
+        memcpy(chunks.load(memory_order_relaxed)[offset / CHUNKSIZE] + offset % CHUNKSIZE, text.data(), text.size());
+        entry.length[id % BLOCKSIZE] = text.size();
+    }
+    else
+    {
+        id = nextId++;
+        if(id % BLOCKSIZE == 0)
+        {
+            int index = id / BLOCKSIZE;
+            if(index == blockCapacity)
+            {
+                Block** old = blocks.load(memory_order_relaxed);
+                Block** grown = new Block*[2 * blockCapacity]();
+                copy(old, old + blockCapacity, grown);
+                blocks.store(grown, memory_order_release);
+                outgrown.push_back(old);
+                blockCapacity *= 2;
+            }
+            blocks.load(memory_order_relaxed)[index] = new Block();
+        }
+
+        Block& entry = block(id);
+        entry.offset[id % BLOCKSIZE] = append(text);
+        entry.length[id % BLOCKSIZE] = text.size();
+        entry.capacity[id % BLOCKSIZE] = text.size();
+    }
+
+    Block& entry = block(id);
+    entry.refs[id % BLOCKSIZE].store(1, memory_order_relaxed);
+    entry.live[id % BLOCKSIZE] = true;
+
+    unsigned int mask = table.size() - 1;
+    slot = hash(text) & mask;
+    while(table[slot] > 0)
+    {
+        slot = (slot + 1) & mask;
+    }
+    usedSlots += table[slot] == EMPTY ? 1 : 0;
+    table[slot] = id + 1;
+    liveLabels++;
+
+    return id;
+}
+
+/*
+ retain:
+ Pre-condition: id is referenced by the caller.
+ Post-condition: id holds one more reference.
+ */
+void LabelPool::retain(int id)
+{
+    if(id != 0)
+    {
+        block(id).refs[id % BLOCKSIZE].fetch_add(1, memory_order_relaxed);
+    }
+}
+
+/*
+ release:
+ Pre-condition: id is referenced by the caller.
+ Post-condition: id holds one reference less. The label is removed once no reference is left, and its id and its bytes of the arena may be given to another label.
+ */
+void LabelPool::release(int id)
+{
+    if(id == 0)
+    {
+        return;
+    }
+
+    Block& entry = block(id);
+    int i = id % BLOCKSIZE;
+    if(entry.refs[i].fetch_sub(1, memory_order_acq_rel) != 1)
+    {
+        return;
+    }
+
+    // intern may have handed the label out again before the lock was taken
+    lock_guard<mutex> guard(lock);
+    if(!entry.live[i] || entry.refs[i].load(memory_order_acquire) != 0)
+    {
+        return;
+    }
+
+    table[slotOf(view(id))] = REMOVED;
+    entry.live[i] = false;
+    freeIds.insert(pair<int, int>(entry.capacity[i], id));
+    liveLabels--;
+}
+
+/*
+ view:
+ Pre-condition: id is referenced by the caller.
+ Post-condition: The text of the label is returned. It stays valid while the reference is held.
+ */
+string_view LabelPool::view(int id) const
+{
+    const Block& entry = block(id);
+    int i = id % BLOCKSIZE;
+    if(entry.length[i] == 0)
+    {
+        return string_view();
+    }
+
+    long long offset = entry.offset[i];
+    return string_view(chunks.load(memory_order_acquire)[offset / CHUNKSIZE] + offset % CHUNKSIZE, entry.length[i]);
+}
+
+/*
+ block:
+ Pre-condition: id has been given out by intern.
+ Post-condition: The block holding id is returned.
+ */
+LabelPool::Block& LabelPool::block(int id) const
+{
+    return *blocks.load(memory_order_acquire)[id / BLOCKSIZE];
+}
+
+/*
+ append:
+ Pre-condition: The lock is held.
+ Post-condition: text is copied to the end of the arena and its offset is returned. A label that does not fit in the rest of the last chunk starts a new one, and one longer than a chunk gets a chunk of its own.
+ */
+long long LabelPool::append(string_view text)
+{
+    if(text.empty())
+    {
+        return 0;
+    }
+
+    if(chunkUsed + (long long)text.size() > CHUNKSIZE)
+    {
+        if(chunkCount == chunkCapacity)
+        {
+            char** old = chunks.load(memory_order_relaxed);
+            char** grown = new char*[2 * chunkCapacity]();
+            copy(old, old + chunkCapacity, grown);
+            chunks.store(grown, memory_order_release);
+            outgrown.push_back(old);
+            chunkCapacity *= 2;
+        }
+        chunks.load(memory_order_relaxed)[chunkCount] = new char[max((size_t)CHUNKSIZE, text.size())];
+        chunkCount++;
+        chunkUsed = 0;
+    }
+
+    // a label longer than a chunk leaves chunkUsed past the end, so the next label starts a new chunk
+    long long offset = (long long)(chunkCount - 1) * CHUNKSIZE + chunkUsed;
+    memcpy(chunks.load(memory_order_relaxed)[chunkCount - 1] + chunkUsed, text.data(), text.size());
+    chunkUsed += text.size();
+    return offset;
+}
+
+/*
+ slotOf:
+ Pre-condition: The lock is held.
+ Post-condition: The slot of the table holding text is returned, or -1 if text is not in the table.
+ */
+int LabelPool::slotOf(string_view text) const
+{
+    unsigned int mask = table.size() - 1;
+    for(unsigned int slot = hash(text) & mask; table[slot] != EMPTY; slot = (slot + 1) & mask)
+    {
+        if(table[slot] != REMOVED && view(table[slot] - 1) == text)
+        {
+            return slot;
+        }
+    }
+    return -1;
+}
+
+/*
+ rehash:
+ Pre-condition: The lock is held.
+ Post-condition: The table is at least four times as large as the number of labels and holds no removed slots.
+ */
+void LabelPool::rehash()
+{
+    vector<int> old;
+    old.swap(table);
+
+    // released labels free their slots, so the table only doubles when live labels need it
+    int slots = old.size();
+    while(4 * (liveLabels + 1) > slots)
+    {
+        slots *= 2;
+    }
+    table.assign(slots, 0);
+    unsigned int mask = table.size() - 1;
+
+    for(int i = 0; i < (int)old.size(); i++)
+    {
+        if(old[i] > 0)
+        {
+            unsigned int slot = hash(view(old[i] - 1)) & mask;
+            while(table[slot] != EMPTY)
+            {
+                slot = (slot + 1) & mask;
+            }
+            table[slot] = old[i];
+        }
+    }
+    usedSlots = liveLabels;
+}
@@ -0,0 +1,185 @@
+/*****************************************************************/
+/* LabelPool.h
+/*
+/* Author: Hans Nicolaus
+/*
+/* This header file contains the interfaces of method implementations
+/* of the LabelPool class, which hides the implementations
+/* of all methods that are implemented in the LabelPool.cpp file.
+/*
+/* The LabelPool stores every distinct vertex label once, back to back
+/* in an arena of character chunks, and gives each a small integer id.
+/* A NodeData only keeps that id, so copying or comparing labels for
+/* equality is an integer operation. Every NodeData holds a reference
+/* to its label, and a label is released once the last graph using it
+/* is gone, so replacing graph versions does not make the pool grow
+/* without end.
+/*
+/* The arena is only ever appended to and its chunks are never moved or
+/* freed, so a label is addressed by its offset in the arena and the
+/* view of a referenced label stays valid while other threads intern
+/* new ones. The offset, length and reference count of each id are
+/* kept in parallel arrays, allocated a block of ids at a time. The
+/* tables of chunks and of blocks double when they fill up; view reads
+/* them without the lock, so an outgrown table is kept rather than
+/* freed. A released id keeps its bytes of the arena, and the next
+/* label that fits in them is given that id, so relabelling the same
+/* vertices over and over reuses the same space. The empty label, id 0,
+/* is never released and is not reference counted, as every unused
+/* NodeData holds it.
+/*
+/*****************************************************************/
+
+#ifndef LABELPOOL_H
+#define LABELPOOL_H
+#include <atomic>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <mutex>
+using namespace std;
+
+class LabelPool
+{
+public:
+    const static int BLOCKSIZE = 1024;            // ids in one block of the parallel arrays
+    const static int CHUNKSIZE = 65536;           // bytes in one chunk of the arena
+
+    /*
+     instance:
+     Pre-condition: None.
+     Post-condition: The pool shared by every NodeData is returned. The empty label always has id 0.
+     */
+    static LabelPool& instance();
+
+    /*
+     intern:
+     Pre-condition: text is the label to be stored.
+     Post-condition: The id of text is returned, holding one reference the caller has to release. The text is added to the pool only if it is not there yet.
+     */
+    int intern(string_view text);
+
+    /*
+     retain:
+     Pre-condition: id is referenced by the caller.
+     Post-condition: id holds one more reference.
+     */
+    void retain(int id);
+
+    /*
+     release:
+     Pre-condition: id is referenced by the caller.
+     Post-condition: id holds one reference less. The label is removed once no reference is left, and its id and its bytes of the arena may be given to another label.
+     */
+    void release(int id);
+
+    /*
+     find:
+     Pre-condition: text is the label to be looked up.
+     Post-condition: The id of text is returned, or -1 if it is not in the pool. No reference is taken, so the id is only meaningful while the caller holds one some other way. Unlike view, it takes the lock.
+     */
+    int find(string_view text);
+
+    /*
+     view:
+     Pre-condition: id is referenced by the caller.
+     Post-condition: The text of the label is returned. It stays valid while the reference is held.
+     */
+    string_view view(int id) const;
+
+    /*
+     hash:
+     Pre-condition: None.
+     Post-condition: The FNV-1a hash of label is returned.
+     */
+    static unsigned int hash(string_view label);
+
+private:
+    /*
+     Default constructor:
+     Pre-condition: Sufficient memory is available.
+     Post-condition: The pool holds only the empty label.
+     */
+    LabelPool();
+
+    LabelPool(const LabelPool&);                  // the pool cannot be copied
+    LabelPool& operator=(const LabelPool&);
+
+    /*
+     Block: the parallel arrays of BLOCKSIZE ids. Only refs changes
+     without the lock, and offset and length only change while no
+     reference to the id is held.
+     */
+    struct Block
+    {
+        long long offset[BLOCKSIZE];              // where the text starts in the arena
+
+        int length[BLOCKSIZE];                    // bytes of text
+
+        int capacity[BLOCKSIZE];                  // bytes of the arena owned by the id, kept once released
+
+        atomic<int> refs[BLOCKSIZE];              // NodeData holding the id
+
+        bool live[BLOCKSIZE];                     // whether the id is in use
+    };
+
+    /*
+     block:
+     Pre-condition: id has been given out by intern.
+     Post-condition: The block holding id is returned.
+     */
+    Block& block(int id) const;
+
+    /*
+     append:
+     Pre-condition: The lock is held.
+     Post-condition: text is copied to the end of the arena and its offset is returned. A label that does not fit in the rest of the last chunk starts a new one, and one longer than a chunk gets a chunk of its own.
+     */
+    long long append(string_view text);
+
+    /*
+     slotOf:
+     Pre-condition: The lock is held.
+     Post-condition: The slot of the table holding text is returned, or -1 if text is not in the table.
+     */
+    int slotOf(string_view text) const;
+
+    /*
+     rehash:
+     Pre-condition: The lock is held.
+     Post-condition: The table is at least four times as large as the number of labels and holds no removed slots.
+     */
+    void rehash();
+
+    const static int EMPTY = 0;                   // slot never used
+    const static int REMOVED = -1;                // slot of a released label
+
+    atomic<char**> chunks;                        // chunk i holds the arena from offset i * CHUNKSIZE
+
+    int chunkCount;                               // chunks in the arena
+
+    int chunkCapacity;                            // entries in the chunk table
+
+    long long chunkUsed;                          // bytes used of the last chunk
+
+    atomic<Block**> blocks;                       // block i holds ids i * BLOCKSIZE onwards
+
+    int blockCapacity;                            // entries in the block table
+
+    vector<void*> outgrown;                       // tables replaced by larger ones, which readers may still use
+
+    int nextId;                                   // ids below this have been given out
+
+    multimap<int, int> freeIds;                   // released ids by the bytes of the arena they own
+
+    vector<int> table;                            // open addressing slots holding id + 1
+
+    int usedSlots;                                // slots not EMPTY
+
+    int liveLabels;                               // labels in the table
+
+    mutex lock;                                   // guards everything but refs and reads of referenced labels
+};
+
+#endif
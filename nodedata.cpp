@@ -1,58 +1,88 @@
 #include "nodedata.h"
+#include "reportwriter.h"
+#include "labelpool.h"
 
 //------------------- constructors/destructor  -------------------------------
-NodeData::NodeData() { data = ""; }                         // default
+NodeData::NodeData() { id = 0; }                            // default, empty string
 
-NodeData::~NodeData() { }            // needed so strings are deleted properly
+NodeData::~NodeData() { LabelPool::instance().release(id); }   // the pool drops the string once unused
 
-NodeData::NodeData(const NodeData& nd) { data = nd.data; }  // copy
+NodeData::NodeData(const NodeData& nd) {            // copy
+	id = nd.id;
+	LabelPool::instance().retain(id);
+}
 
-NodeData::NodeData(const string& s) { data = s; }    // cast string to NodeData
+NodeData::NodeData(const string& s) {                // cast string to NodeData
+	id = LabelPool::instance().intern(s);
+}
 
 //------------------------- operator= ----------------------------------------
 NodeData& NodeData::operator=(const NodeData& rhs) {
 	if (this != &rhs) {
-		data = rhs.data;
+		LabelPool::instance().retain(rhs.id);
+		LabelPool::instance().release(id);
+		id = rhs.id;
 	}
 	return *this;
 }
 
 //------------------------- operator==,!= ------------------------------------
+// interned strings are equal exactly when their ids are
 bool NodeData::operator==(const NodeData& rhs) const {
-	return data == rhs.data;
+	return id == rhs.id;
 }
 
 bool NodeData::operator!=(const NodeData& rhs) const {
-	return data != rhs.data;
+	return id != rhs.id;
 }
 
 //------------------------ operator<,>,<=,>= ---------------------------------
 bool NodeData::operator<(const NodeData& rhs) const {
-	return data < rhs.data;
+	return getData() < rhs.getData();
 }
 
 bool NodeData::operator>(const NodeData& rhs) const {
-	return data > rhs.data;
+	return getData() > rhs.getData();
 }
 
 bool NodeData::operator<=(const NodeData& rhs) const {
-	return data <= rhs.data;
+	return getData() <= rhs.getData();
 }
 
 bool NodeData::operator>=(const NodeData& rhs) const {
-	return data >= rhs.data;
+	return getData() >= rhs.getData();
 }
 
 //------------------------------ setData -------------------------------------
 // returns true if the data is set, false when bad data, i.e., is eof
 
 bool NodeData::setData(istream& infile) {
-	getline(infile, data);
+	static thread_local string line;   // reused so reading does not allocate
+	getline(infile, line);
+	int old = id;
+	id = LabelPool::instance().intern(line);
+	LabelPool::instance().release(old);
 	return !infile.eof();       // eof function is true when eof char is read
 }
 
+//------------------------------ getId, getData ------------------------------
+int NodeData::getId() const {
+	return id;
+}
+
+string_view NodeData::getData() const {
+	return LabelPool::instance().view(id);
+}
+
 //-------------------------- operator<< --------------------------------------
 ostream& operator<<(ostream& output, const NodeData& nd) {
-	output << nd.data;
+	output << nd.getData();
+	return output;
+}
+
+//-------------------------- operator<< --------------------------------------
+// appends the string to a buffered report instead of a stream
+ReportWriter& operator<<(ReportWriter& output, const NodeData& nd) {
+	output << nd.getData();
 	return output;
 }
@@ -3,13 +3,18 @@
 #include <string>
 #include <iostream>
 #include <fstream>
+#include <string_view>
 using namespace std;
 
+class ReportWriter;
+
 // simple class containing one string to use for testing
 // not necessary to comment further
+// the string lives in the LabelPool, NodeData only keeps its id and a reference to it
 
 class NodeData {
 	friend ostream & operator<<(ostream &, const NodeData &);
+	friend ReportWriter & operator<<(ReportWriter &, const NodeData &);
 
 public:
 	NodeData();          // default constructor, data is set to an empty string
@@ -29,8 +34,11 @@ public:
 	bool operator<=(const NodeData &) const;
 	bool operator>=(const NodeData &) const;
 
+	int getId() const;            // id of the string in the LabelPool
+	string_view getData() const;  // the string, valid while this NodeData keeps its id
+
 private:
-	string data;
+	int id;                       // equal strings always share one id, referenced in the pool
 };
 
 #endif
@@ -0,0 +1,254 @@
+/*****************************************************************/
+/* PartitionedSearch.cpp
+/*
+/* Author: Hans Nicolaus
+/*
+/* This file contains the implementations of the constructors and
+/* methods which interfaces are defined in the PartitionedSearch.h file
+/*
+/*****************************************************************/
+
+#include "partitionedsearch.h"
+#include "perfcounters.h"
+#include <climits>
+#include <functional>
+#include <queue>
+#include <thread>
+
+const static unsigned long long UNREACHED = ~0ULL;    // packed word of a vertex not yet reached
+
+const static int BATCHSIZE = 256;                     // vertices per message to another part
+
+/*
+ Constructor:
+ Pre-condition: graph is the graph to search.
+                part holds the part of each vertex, from 0 to parts - 1, as written by GraphPartitioner::partition.
+ Post-condition: The search is ready, with one thread per part to be started by each query. graph and part must outlive it.
+ */
+PartitionedSearch::PartitionedSearch(const CSRGraph& graph, const vector<int>& part, int parts) : graph(graph), part(part), parts(parts), best(graph.getVertexCount() + 1), expanded(graph.getVertexCount() + 1), inboxes(parts), pending(0)
+{
+}
+
+/*
+ shortestPaths:
+ Pre-condition: source is a vertex of the graph.
+                No other query runs on this object.
+ Post-condition: dist[v] holds the shortest distance from source to v and path[v] the vertex before v on that path, for v from 1 to the vertex count. Unreachable vertices have the largest int and 0.
+ */
+void PartitionedSearch::shortestPaths(int source, vector<int>& dist, vector<int>& path)
+{
+    search(source, dist, path, false);
+}
+
+/*
+ breadthFirst:
+ Pre-condition: source is a vertex of the graph.
+                No other query runs on this object.
+ Post-condition: level[v] holds the number of edges on the shortest path from source to v, or the largest int if v cannot be reached.
+ */
+void PartitionedSearch::breadthFirst(int source, vector<int>& level)
+{
+    vector<int> path;
+    search(source, level, path, true);
+}
+
+/*
+ search:
+ Pre-condition: source is a vertex of the graph.
+ Post-condition: dist and path hold the result of the search, counting every edge as 1 if unitWeights is true.
+ */
+void PartitionedSearch::search(int source, vector<int>& dist, vector<int>& path, bool unitWeights)
+{
+    int n = graph.getVertexCount();
+    dist.assign(n + 1, INT_MAX);
+    path.assign(n + 1, 0);
+    if(source < 1 || source > n)
+    {
+        return;
+    }
+
+    for(int v = 0; v <= n; v++)
+    {
+        best[v].store(UNREACHED, memory_order_relaxed);
+        expanded[v] = INT_MAX;
+    }
+    best[source].store((unsigned long long)source, memory_order_relaxed);
+    pending.store(1);
+    vector<int> first(1, source);
+    inboxes[part[source]].push(first);
+
+    vector<thread> threads;
+    for(int p = 0; p < parts; p++)
+    {
+        threads.push_back(thread(&PartitionedSearch::runPart, this, p, unitWeights));
+    }
+    for(int p = 0; p < parts; p++)
+    {
+        threads[p].join();
+    }
+
+    for(int v = 1; v <= n; v++)
+    {
+        unsigned long long packed = best[v].load(memory_order_relaxed);
+        if(packed != UNREACHED)
+        {
+            dist[v] = packed >> 32;
+            path[v] = packed & 0xffffffffULL;
+        }
+    }
+}
+
+/*
+ runPart:
+ Pre-condition: best and inboxes are set up for a search.
+ Post-condition: The vertices of part p were expanded until no work was left anywhere.
+ */
+void PartitionedSearch::runPart(int p, bool unitWeights)
+{
+    typedef pair<long long, int> Entry;                   // distance, vertex
+    priority_queue<Entry, vector<Entry>, greater<Entry> > heap;
+    vector<vector<int> > outgoing(parts);
+    vector<int> batch;
+
+    for(;;)
+    {
+        while(inboxes[p].pop(batch))
+        {
+            for(int i = 0; i < (int)batch.size(); i++)
+            {
+                heap.push(Entry(best[batch[i]].load(memory_order_acquire) >> 32, batch[i]));
+            }
+        }
+
+        if(heap.empty())
+        {
+            // nothing to do here, so whatever is buffered for other parts has to go now
+            for(int q = 0; q < parts; q++)
+            {
+                if(!outgoing[q].empty())
+                {
+                    inboxes[q].push(outgoing[q]);
+                }
+            }
+            if(pending.load() == 0)
+            {
+                return;
+            }
+            this_thread::yield();
+            continue;
+        }
+
+        Entry top = heap.top();
+        heap.pop();
+        int v = top.second;
+        long long d = top.first;
+
+        // entries are stale once the vertex got shorter or was already expanded at this distance
+        if((long long)(best[v].load(memory_order_acquire) >> 32) == d && expanded[v] != d)
+        {
+            expanded[v] = d;
+            PERF_COUNT(VERTICES_SETTLED, 1);
+            for(long long e = graph.edgeBegin(v); e < graph.edgeEnd(v); e++)
+            {
+                PERF_COUNT(EDGES_RELAXED, 1);
+                int w = graph.getTarget(e);
+
+                // a distance that reaches the largest int would not fit the high half, so w stays unreached
+                long long reach = d + (unitWeights ? 1 : graph.getWeight(e));
+                if(reach >= INT_MAX)
+                {
+                    continue;
+                }
+                unsigned long long candidate = (unsigned long long)reach << 32 | v;
+                unsigned long long current = best[w].load(memory_order_relaxed);
+                while(candidate < current && !best[w].compare_exchange_weak(current, candidate, memory_order_acq_rel))
+                {
+                }
+                if(candidate >= current)
+                {
+                    continue;
+                }
+
+                pending++;
+                if(part[w] == p)
+                {
+                    heap.push(Entry(candidate >> 32, w));
+                }
+                else
+                {
+                    outgoing[part[w]].push_back(w);
+                    if((int)outgoing[part[w]].size() >= BATCHSIZE)
+                    {
+                        inboxes[part[w]].push(outgoing[part[w]]);
+                    }
+                }
+            }
+        }
+        pending--;
+    }
+}
+
+/*
+ Inbox constructor:
+ Pre-condition: None.
+ Post-condition: The inbox holds only its stub node.
+ */
+PartitionedSearch::Inbox::Inbox()
+{
+    Node* stub = new Node;
+    stub->next.store(NULL, memory_order_relaxed);
+    head.store(stub, memory_order_relaxed);
+    tail = stub;
+}
+
+/*
+ ~Inbox:
+ Pre-condition: No thread is using the inbox.
+ Post-condition: Every node is deallocated.
+ */
+PartitionedSearch::Inbox::~Inbox()
+{
+    while(tail != NULL)
+    {
+        Node* next = tail->next.load(memory_order_relaxed);
+        delete tail;
+        tail = next;
+    }
+}
+
+/*
+ push:
+ Pre-condition: batch holds vertices for the owner. Any thread may call it.
+ Post-condition: The batch is queued and batch is left empty.
+ */
+void PartitionedSearch::Inbox::push(vector<int>& batch)
+{
+    Node* node = new Node;
+    node->next.store(NULL, memory_order_relaxed);
+    node->vertices.swap(batch);
+    batch.clear();
+
+    Node* previous = head.exchange(node, memory_order_acq_rel);
+    previous->next.store(node, memory_order_release);
+}
+
+/*
+ pop:
+ Pre-condition: Only the owning thread calls it.
+ Post-condition: The oldest batch is moved into batch and true returned, or false is returned if none is queued.
+ */
+bool PartitionedSearch::Inbox::pop(vector<int>& batch)
+{
+    Node* next = tail->next.load(memory_order_acquire);
+    if(next == NULL)
+    {
+        return false;
+    }
+
+    // the popped node becomes the new stub
+    batch.clear();
+    batch.swap(next->vertices);
+    delete tail;
+    tail = next;
+    return true;
+}
@@ -0,0 +1,131 @@
+/*****************************************************************/
+/* PartitionedSearch.h
+/*
+/* Author: Hans Nicolaus
+/*
+/* This header file contains the interfaces of method implementations
+/* of the PartitionedSearch class, which hides the implementations
+/* of all methods that are implemented in the PartitionedSearch.cpp file.
+/*
+/* PartitionedSearch runs shortest path and breadth-first searches on a
+/* CSRGraph split by the GraphPartitioner, with one thread per part.
+/* Each thread keeps its own heap of the vertices in its part and only
+/* relaxes their edges. An edge into another part lowers the distance of
+/* its end with a compare-and-swap and sends the vertex to the owning
+/* thread through that thread's lock-free inbox, so threads never wait
+/* on each other. Messages are sent in batches, one per destination.
+/*
+/* Distance and parent of a vertex are packed into one 64-bit word,
+/* distance high, so a smaller word is always a shorter path and both
+/* change together. A path as long as the largest int or longer does
+/* not fit, and its end is left unreached. The search ends when a
+/* shared count of vertices queued but not yet expanded drops to zero.
+/*
+/* The distances, inboxes and pending count of a search are members, so
+/* one PartitionedSearch runs one query at a time. Threads that query
+/* the same graph at once need a PartitionedSearch each.
+/*
+/*****************************************************************/
+
+#ifndef PARTITIONEDSEARCH_H
+#define PARTITIONEDSEARCH_H
+#include "csrgraph.h"
+#include <atomic>
+#include <vector>
+using namespace std;
+
+class PartitionedSearch
+{
+public:
+    /*
+     Constructor:
+     Pre-condition: graph is the graph to search.
+                    part holds the part of each vertex, from 0 to parts - 1, as written by GraphPartitioner::partition.
+     Post-condition: The search is ready, with one thread per part to be started by each query. graph and part must outlive it.
+     */
+    PartitionedSearch(const CSRGraph& graph, const vector<int>& part, int parts);
+
+    /*
+     shortestPaths:
+     Pre-condition: source is a vertex of the graph.
+                    No other query runs on this object.
+     Post-condition: dist[v] holds the shortest distance from source to v and path[v] the vertex before v on that path, for v from 1 to the vertex count. Unreachable vertices have the largest int and 0.
+     */
+    void shortestPaths(int source, vector<int>& dist, vector<int>& path);
+
+    /*
+     breadthFirst:
+     Pre-condition: source is a vertex of the graph.
+                    No other query runs on this object.
+     Post-condition: level[v] holds the number of edges on the shortest path from source to v, or the largest int if v cannot be reached.
+     */
+    void breadthFirst(int source, vector<int>& level);
+
+private:
+    /*
+     Inbox: a multiple producer, single consumer queue of message batches.
+     Producers swap their batch in at head; the owner follows next
+     pointers from tail. The first node is an empty stub.
+     */
+    class Inbox
+    {
+    public:
+        Inbox();
+        ~Inbox();
+
+        /*
+         push:
+         Pre-condition: batch holds vertices for the owner. Any thread may call it.
+         Post-condition: The batch is queued and batch is left empty.
+         */
+        void push(vector<int>& batch);
+
+        /*
+         pop:
+         Pre-condition: Only the owning thread calls it.
+         Post-condition: The oldest batch is moved into batch and true returned, or false is returned if none is queued.
+         */
+        bool pop(vector<int>& batch);
+
+    private:
+        struct Node
+        {
+            atomic<Node*> next;
+            vector<int> vertices;
+        };
+
+        atomic<Node*> head;                       // last node pushed
+
+        Node* tail;                               // last node popped, owned by the consumer
+    };
+
+    /*
+     search:
+     Pre-condition: source is a vertex of the graph.
+     Post-condition: dist and path hold the result of the search, counting every edge as 1 if unitWeights is true.
+     */
+    void search(int source, vector<int>& dist, vector<int>& path, bool unitWeights);
+
+    /*
+     runPart:
+     Pre-condition: best and inboxes are set up for a search.
+     Post-condition: The vertices of part p were expanded until no work was left anywhere.
+     */
+    void runPart(int p, bool unitWeights);
+
+    const CSRGraph& graph;
+
+    const vector<int>& part;                      // owning part of each vertex
+
+    int parts;
+
+    vector<atomic<unsigned long long> > best;     // distance << 32 | parent, per vertex
+
+    vector<int> expanded;                         // distance a vertex was last expanded at, touched only by its owner
+
+    vector<Inbox> inboxes;                        // one per part
+
+    atomic<long long> pending;                    // vertices queued but not expanded
+};
+
+#endif
@@ -0,0 +1,280 @@
+/*****************************************************************/
+/* PerfCounters.cpp
+/*
+/* Author: Hans Nicolaus
+/*
+/* This file contains the implementations of the constructors and
+/* methods which interfaces are defined in the PerfCounters.h file
+/*
+/*****************************************************************/
+
+#include "perfcounters.h"
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+// names used by both exports, in the order of the enums
+static const char* COUNTERNAMES[PerfCounters::NUMCOUNTERS] = { "vertices_settled", "edges_relaxed", "heap_operations", "bytes_allocated" };
+static const char* PHASENAMES[PerfCounters::NUMPHASES] = { "build_graph", "find_shortest_path", "solve_source", "dfs" };
+
+/*
+ Registry: the counters of every running thread, and the sum of the
+ counters of the threads that have ended.
+ */
+struct PerfRegistry
+{
+    mutex lock;
+
+    vector<PerfCounters*> threads;                // counters of running threads
+
+    PerfCounters retired;                         // counts left by ended threads
+};
+
+/*
+ registry:
+ Pre-condition: None.
+ Post-condition: The registry is returned. It is built on first use, so it exists before any thread registers.
+ */
+static PerfRegistry& registry()
+{
+    static PerfRegistry instance;
+    return instance;
+}
+
+/*
+ PerfRegistration: the counters of one thread, listed in the registry
+ for as long as the thread runs.
+ */
+struct PerfRegistration
+{
+    PerfCounters counters;
+
+    PerfRegistration()
+    {
+        PerfRegistry& shared = registry();
+        lock_guard<mutex> guard(shared.lock);
+        shared.threads.push_back(&counters);
+    }
+
+    ~PerfRegistration()
+    {
+        PerfRegistry& shared = registry();
+        lock_guard<mutex> guard(shared.lock);
+        shared.retired.merge(counters);
+        shared.threads.erase(find(shared.threads.begin(), shared.threads.end(), &counters));
+    }
+};
+
+/*
+ Default constructor:
+ Pre-condition: None.
+ Post-condition: All counters and histograms are zero.
+ */
+PerfCounters::PerfCounters()
+{
+    reset();
+}
+
+/*
+ local:
+ Pre-condition: None.
+ Post-condition: The counters of the calling thread are returned. They are added to the registry on first use, and their counts are kept in the registry when the thread ends.
+ */
+PerfCounters& PerfCounters::local()
+{
+    thread_local PerfRegistration registration;
+    return registration.counters;
+}
+
+/*
+ collect:
+ Pre-condition: None.
+ Post-condition: total holds the sum of the counters of every thread that has counted anything, including threads that have ended. Any thread may call it while others count.
+ */
+void PerfCounters::collect(PerfCounters& total)
+{
+    total.reset();
+
+    PerfRegistry& shared = registry();
+    lock_guard<mutex> guard(shared.lock);
+    total.merge(shared.retired);
+    for(int t = 0; t < (int)shared.threads.size(); t++)
+    {
+        total.merge(*shared.threads[t]);
+    }
+}
+
+/*
+ add:
+ Pre-condition: amount is the work done.
+ Post-condition: amount is added to counter.
+ */
+void PerfCounters::add(Counter counter, long amount)
+{
+    bump(counters[counter], amount);
+}
+
+/*
+ record:
+ Pre-condition: nanos is the time a phase took.
+ Post-condition: nanos is added to the histogram of phase.
+ */
+void PerfCounters::record(Phase phase, long nanos)
+{
+    int bucket = 0;
+    while(bucket < NUMBUCKETS && (nanos >> (bucket + 1)) != 0)
+    {
+        bucket++;
+    }
+
+    // bucket NUMBUCKETS holds every time of 2^NUMBUCKETS nanoseconds or more
+    bump(histogram[phase][bucket], 1);
+    bump(phaseCount[phase], 1);
+    bump(phaseNanos[phase], nanos);
+}
+
+/*
+ get:
+ Pre-condition: None.
+ Post-condition: The value of counter is returned.
+ */
+long PerfCounters::get(Counter counter) const
+{
+    return counters[counter].load(memory_order_relaxed);
+}
+
+/*
+ reset:
+ Pre-condition: None.
+ Post-condition: All counters and histograms are zero, so the next query is counted on its own.
+ */
+void PerfCounters::reset()
+{
+    for(int c = 0; c < NUMCOUNTERS; c++)
+    {
+        counters[c].store(0, memory_order_relaxed);
+    }
+
+    for(int p = 0; p < NUMPHASES; p++)
+    {
+        for(int b = 0; b <= NUMBUCKETS; b++)
+        {
+            histogram[p][b].store(0, memory_order_relaxed);
+        }
+        phaseCount[p].store(0, memory_order_relaxed);
+        phaseNanos[p].store(0, memory_order_relaxed);
+    }
+}
+
+/*
+ merge:
+ Pre-condition: other holds the counters of another thread.
+ Post-condition: The counters and histograms of other are added to these.
+ */
+void PerfCounters::merge(const PerfCounters& other)
+{
+    for(int c = 0; c < NUMCOUNTERS; c++)
+    {
+        bump(counters[c], other.counters[c].load(memory_order_relaxed));
+    }
+
+    for(int p = 0; p < NUMPHASES; p++)
+    {
+        for(int b = 0; b <= NUMBUCKETS; b++)
+        {
+            bump(histogram[p][b], other.histogram[p][b].load(memory_order_relaxed));
+        }
+        bump(phaseCount[p], other.phaseCount[p].load(memory_order_relaxed));
+        bump(phaseNanos[p], other.phaseNanos[p].load(memory_order_relaxed));
+    }
+}
+
+/*
+ writeJSON:
+ Pre-condition: output is the stream that receives the export.
+ Post-condition: The counters and histograms are written as one JSON object.
+ */
+void PerfCounters::writeJSON(ostream& output) const
+{
+    output << "{\"counters\":{";
+    for(int c = 0; c < NUMCOUNTERS; c++)
+    {
+        output << (c == 0 ? "" : ",") << '"' << COUNTERNAMES[c] << "\":" << counters[c];
+    }
+
+    output << "},\"phases\":{";
+    for(int p = 0; p < NUMPHASES; p++)
+    {
+        output << (p == 0 ? "" : ",") << '"' << PHASENAMES[p] << "\":{\"count\":" << phaseCount[p];
+        output << ",\"nanos\":" << phaseNanos[p] << ",\"histogram\":[";
+        for(int b = 0; b <= NUMBUCKETS; b++)
+        {
+            output << (b == 0 ? "" : ",") << histogram[p][b];
+        }
+        output << "]}";
+    }
+    output << "}}" << '\n';
+}
+
+/*
+ writePrometheus:
+ Pre-condition: output is the stream that receives the export.
+ Post-condition: The counters and histograms are written in the Prometheus text exposition format.
+ */
+void PerfCounters::writePrometheus(ostream& output) const
+{
+    for(int c = 0; c < NUMCOUNTERS; c++)
+    {
+        output << "# TYPE graph_" << COUNTERNAMES[c] << "_total counter" << '\n';
+        output << "graph_" << COUNTERNAMES[c] << "_total " << counters[c] << '\n';
+    }
+
+    output << "# TYPE graph_phase_seconds histogram" << '\n';
+    for(int p = 0; p < NUMPHASES; p++)
+    {
+        // Prometheus buckets are cumulative and bounded by seconds; +Inf adds the longer times.
+        // le is inclusive, so each bucket is bounded by the longest whole nanosecond time it holds,
+        // printed with enough digits that it does not round up into the next bucket
+        long cumulative = 0;
+        streamsize precision = output.precision(15);
+        for(int b = 0; b < NUMBUCKETS; b++)
+        {
+            cumulative += histogram[p][b];
+            output << "graph_phase_seconds_bucket{phase=\"" << PHASENAMES[p] << "\",le=\"" << (double)((2L << b) - 1) / 1e9 << "\"} " << cumulative << '\n';
+        }
+        output.precision(precision);
+        output << "graph_phase_seconds_bucket{phase=\"" << PHASENAMES[p] << "\",le=\"+Inf\"} " << phaseCount[p] << '\n';
+        output << "graph_phase_seconds_sum{phase=\"" << PHASENAMES[p] << "\"} " << phaseNanos[p] * 1e-9 << '\n';
+        output << "graph_phase_seconds_count{phase=\"" << PHASENAMES[p] << "\"} " << phaseCount[p] << '\n';
+    }
+}
+
+/*
+ bump:
+ Pre-condition: Only the owning thread changes value.
+ Post-condition: amount is added to value. Readers on other threads see either the old or the new value, and no locked instruction is used.
+ */
+void PerfCounters::bump(atomic<long>& value, long amount)
+{
+    value.store(value.load(memory_order_relaxed) + amount, memory_order_relaxed);
+}
+
+/*
+ ScopedTimer constructor:
+ Pre-condition: phase is the phase about to run.
+ Post-condition: The start time of the phase is remembered.
+ */
+PerfCounters::ScopedTimer::ScopedTimer(Phase phase) : phase(phase), start(chrono::steady_clock::now())
+{
+}
+
+/*
+ ~ScopedTimer:
+ Pre-condition: The phase has finished.
+ Post-condition: The time the phase took is recorded for the calling thread.
+ */
+PerfCounters::ScopedTimer::~ScopedTimer()
+{
+    long nanos = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+    PerfCounters::local().record(phase, nanos);
+}
@@ -0,0 +1,165 @@
+/*****************************************************************/
+/* PerfCounters.h
+/*
+/* Author: Hans Nicolaus
+/*
+/* This header file contains the interfaces of method implementations
+/* of the PerfCounters class, which hides the implementations
+/* of all methods that are implemented in the PerfCounters.cpp file.
+/*
+/* PerfCounters counts the work done inside the graph algorithms and
+/* keeps a histogram of how long each phase takes. Every thread has its
+/* own counters, so counting needs no locks. Each thread's counters are
+/* listed in a registry the first time they are used, and collect adds
+/* up every thread, running or finished, for export. The PERF_COUNT and
+/* PERF_TIME macros compile to nothing unless GRAPH_PERF_COUNTERS is
+/* defined, so the counters cost nothing in a normal build.
+/*
+/*****************************************************************/
+
+#ifndef PERFCOUNTERS_H
+#define PERFCOUNTERS_H
+#include <atomic>
+#include <chrono>
+#include <iostream>
+using namespace std;
+
+class PerfCounters
+{
+public:
+    /*
+     Counter: the kinds of work that are counted. HEAP_OPERATIONS counts
+     each time the next closest vertex is selected, which is a scan of
+     the distance row in GraphM. BYTES_ALLOCATED counts heap storage as
+     it is allocated: graph nodes, each new graph version and the vectors
+     a query sets up or grows. Storage that is only reset, like the rows
+     of the GraphM tables, is not counted.
+     */
+    enum Counter { VERTICES_SETTLED, EDGES_RELAXED, HEAP_OPERATIONS, BYTES_ALLOCATED, NUMCOUNTERS };
+
+    /*
+     Phase: the parts of the algorithms that are timed.
+     */
+    enum Phase { BUILD_GRAPH, FIND_SHORTEST_PATH, SOLVE_SOURCE, DFS, NUMPHASES };
+
+    const static int NUMBUCKETS = 40;     // bucket i holds times below 2^(i+1) nanoseconds, and one more bucket holds longer times
+
+    /*
+     ScopedTimer: records the time from its creation until it goes out
+     of scope in the histogram of one phase.
+     */
+    class ScopedTimer
+    {
+    public:
+        ScopedTimer(Phase phase);
+
+        ~ScopedTimer();
+
+    private:
+        Phase phase;                                  // phase being timed
+
+        chrono::steady_clock::time_point start;       // time the phase began
+    };
+
+    /*
+     Default constructor:
+     Pre-condition: None.
+     Post-condition: All counters and histograms are zero.
+     */
+    PerfCounters();
+
+    /*
+     local:
+     Pre-condition: None.
+     Post-condition: The counters of the calling thread are returned. They are added to the registry on first use, and their counts are kept in the registry when the thread ends.
+     */
+    static PerfCounters& local();
+
+    /*
+     collect:
+     Pre-condition: None.
+     Post-condition: total holds the sum of the counters of every thread that has counted anything, including threads that have ended. Any thread may call it while others count.
+     */
+    static void collect(PerfCounters& total);
+
+    /*
+     add:
+     Pre-condition: amount is the work done.
+     Post-condition: amount is added to counter.
+     */
+    void add(Counter counter, long amount);
+
+    /*
+     record:
+     Pre-condition: nanos is the time a phase took.
+     Post-condition: nanos is added to the histogram of phase.
+     */
+    void record(Phase phase, long nanos);
+
+    /*
+     get:
+     Pre-condition: None.
+     Post-condition: The value of counter is returned.
+     */
+    long get(Counter counter) const;
+
+    /*
+     reset:
+     Pre-condition: None.
+     Post-condition: All counters and histograms are zero, so the next query is counted on its own.
+     */
+    void reset();
+
+    /*
+     merge:
+     Pre-condition: other holds the counters of another thread.
+     Post-condition: The counters and histograms of other are added to these.
+     */
+    void merge(const PerfCounters& other);
+
+    /*
+     writeJSON:
+     Pre-condition: output is the stream that receives the export.
+     Post-condition: The counters and histograms are written as one JSON object.
+     */
+    void writeJSON(ostream& output) const;
+
+    /*
+     writePrometheus:
+     Pre-condition: output is the stream that receives the export.
+     Post-condition: The counters and histograms are written in the Prometheus text exposition format.
+     */
+    void writePrometheus(ostream& output) const;
+
+private:
+    PerfCounters(const PerfCounters&);            // registered by address, so never copied
+    PerfCounters& operator=(const PerfCounters&);
+
+    /*
+     bump:
+     Pre-condition: Only the owning thread changes value.
+     Post-condition: amount is added to value. Readers on other threads see either the old or the new value, and no locked instruction is used.
+     */
+    static void bump(atomic<long>& value, long amount);
+
+    // atomics only so collect can read them from another thread; only the owner writes them
+    atomic<long> counters[NUMCOUNTERS];                   // work counted so far
+
+    atomic<long> histogram[NUMPHASES][NUMBUCKETS + 1];    // phase times by power of two, then longer times
+
+    atomic<long> phaseCount[NUMPHASES];                   // times each phase ran
+
+    atomic<long> phaseNanos[NUMPHASES];                   // total time of each phase
+};
+
+#ifdef GRAPH_PERF_COUNTERS
+#define PERF_CONCAT_INNER(a, b) a##b
+#define PERF_CONCAT(a, b) PERF_CONCAT_INNER(a, b)
+#define PERF_COUNT(counter, amount) PerfCounters::local().add(PerfCounters::counter, (amount))
+#define PERF_TIME(phase) PerfCounters::ScopedTimer PERF_CONCAT(perfTimer, __LINE__)(PerfCounters::phase)
+#else
+#define PERF_COUNT(counter, amount) ((void)0)
+#define PERF_TIME(phase) ((void)0)
+#endif
+
+#endif
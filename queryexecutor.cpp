@@ -0,0 +1,114 @@
+/*****************************************************************/
+/* QueryExecutor.cpp
+/*
+/* Author: Hans Nicolaus
+/*
+/* This file contains the implementations of the constructors and
+/* methods which interfaces are defined in the QueryExecutor.h file
+/*
+/*****************************************************************/
+
+#include "queryexecutor.h"
+#include <algorithm>
+
+/*
+ Constructor:
+ Pre-condition: threads is the number of threads in the pool, or 0 for one per core.
+ Post-condition: The threads are started and wait for work.
+ */
+QueryExecutor::QueryExecutor(int threads) : stopping(false)
+{
+    if(threads <= 0)
+    {
+        threads = max(1, (int)thread::hardware_concurrency());
+    }
+    for(int t = 0; t < threads; t++)
+    {
+        workers.push_back(thread(&QueryExecutor::run, this));
+    }
+}
+
+/*
+ ~QueryExecutor:
+ Pre-condition: Every query run on the executor has finished or been cancelled.
+ Post-condition: The queue is emptied and the threads are stopped.
+ */
+QueryExecutor::~QueryExecutor()
+{
+    {
+        lock_guard<mutex> guard(lock);
+        stopping = true;
+    }
+    ready.notify_all();
+    for(int t = 0; t < (int)workers.size(); t++)
+    {
+        workers[t].join();
+    }
+}
+
+/*
+ schedule:
+ Pre-condition: None.
+ Post-condition: An awaitable is returned that continues the awaiting coroutine on one of the threads of the pool.
+ */
+QueryExecutor::ScheduleAwaiter QueryExecutor::schedule()
+{
+    return ScheduleAwaiter{*this};
+}
+
+/*
+ post:
+ Pre-condition: waiting is a suspended coroutine.
+ Post-condition: waiting is queued and will be resumed by one of the threads of the pool.
+ */
+void QueryExecutor::post(coroutine_handle<> waiting)
+{
+    {
+        lock_guard<mutex> guard(lock);
+        queue.push_back(waiting);
+    }
+    ready.notify_one();
+}
+
+/*
+ run:
+ Pre-condition: Called by a thread of the pool.
+ Post-condition: Queued coroutines were resumed until the executor was stopped and the queue was empty.
+ */
+void QueryExecutor::run()
+{
+    for(;;)
+    {
+        coroutine_handle<> next;
+        {
+            unique_lock<mutex> guard(lock);
+            ready.wait(guard, [this] { return stopping || !queue.empty(); });
+            if(queue.empty())
+            {
+                return;
+            }
+            next = queue.front();
+            queue.pop_front();
+        }
+        next.resume();
+    }
+}
+
+/*
+ ScheduleAwaiter:
+ Pre-condition: A coroutine awaits the result of schedule.
+ Post-condition: The coroutine always suspends, is queued, and resumes with nothing to return.
+ */
+bool QueryExecutor::ScheduleAwaiter::await_ready() const noexcept
+{
+    return false;
+}
+
+void QueryExecutor::ScheduleAwaiter::await_suspend(coroutine_handle<> waiting) const
+{
+    executor.post(waiting);
+}
+
+void QueryExecutor::ScheduleAwaiter::await_resume() const noexcept
+{
+}
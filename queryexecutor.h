@@ -0,0 +1,96 @@
+/*****************************************************************/
+/* QueryExecutor.h
+/*
+/* Author: Hans Nicolaus
+/*
+/* This header file contains the interfaces of method implementations
+/* of the QueryExecutor class, which hides the implementations
+/* of all methods that are implemented in the QueryExecutor.cpp file.
+/*
+/* A QueryExecutor is a pool of threads that resumes suspended
+/* coroutines in the order they were queued. A query moves onto the
+/* pool with co_await executor.schedule(), and gives up its thread the
+/* same way: it goes to the back of the queue, so queries waiting
+/* behind it get a turn before it continues.
+/*
+/*****************************************************************/
+
+#ifndef QUERYEXECUTOR_H
+#define QUERYEXECUTOR_H
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+using namespace std;
+
+class QueryExecutor
+{
+public:
+    /*
+     ScheduleAwaiter: suspends the awaiting coroutine and queues it on
+     the executor.
+     */
+    struct ScheduleAwaiter
+    {
+        QueryExecutor& executor;
+
+        bool await_ready() const noexcept;
+
+        void await_suspend(coroutine_handle<> waiting) const;
+
+        void await_resume() const noexcept;
+    };
+
+    /*
+     Constructor:
+     Pre-condition: threads is the number of threads in the pool, or 0 for one per core.
+     Post-condition: The threads are started and wait for work.
+     */
+    QueryExecutor(int threads = 0);
+
+    /*
+     ~QueryExecutor:
+     Pre-condition: Every query run on the executor has finished or been cancelled.
+     Post-condition: The queue is emptied and the threads are stopped.
+     */
+    ~QueryExecutor();
+
+    /*
+     schedule:
+     Pre-condition: None.
+     Post-condition: An awaitable is returned that continues the awaiting coroutine on one of the threads of the pool.
+     */
+    ScheduleAwaiter schedule();
+
+    /*
+     post:
+     Pre-condition: waiting is a suspended coroutine.
+     Post-condition: waiting is queued and will be resumed by one of the threads of the pool.
+     */
+    void post(coroutine_handle<> waiting);
+
+private:
+    QueryExecutor(const QueryExecutor&);          // the threads cannot be copied
+    QueryExecutor& operator=(const QueryExecutor&);
+
+    /*
+     run:
+     Pre-condition: Called by a thread of the pool.
+     Post-condition: Queued coroutines were resumed until the executor was stopped and the queue was empty.
+     */
+    void run();
+
+    mutex lock;                                   // guards queue and stopping
+
+    condition_variable ready;                     // signalled when work is queued or the pool stops
+
+    deque<coroutine_handle<> > queue;             // coroutines waiting to be resumed
+
+    bool stopping;                                // set by the destructor
+
+    vector<thread> workers;
+};
+
+#endif
@@ -0,0 +1,287 @@
+/*****************************************************************/
+/* QueryTask.h
+/*
+/* Author: Hans Nicolaus
+/*
+/* This header file contains the QueryTask class template. Being a
+/* template, its methods are implemented at the end of this file
+/* instead of in a .cpp file.
+/*
+/* A QueryTask<T> is the return type of a coroutine that produces a T.
+/* The coroutine does not start when it is called. It starts when the
+/* task is awaited from another coroutine, which is resumed with the T
+/* once it finishes, or when get is called from ordinary code, which
+/* blocks until the T is ready. An exception thrown by the coroutine is
+/* thrown again from co_await or get.
+/*
+/*****************************************************************/
+
+#ifndef QUERYTASK_H
+#define QUERYTASK_H
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+using namespace std;
+
+template <typename T>
+class QueryTask
+{
+public:
+    /*
+     Waiter: lets get sleep until the coroutine finishes. It lives
+     outside the coroutine frame, so the finishing coroutine can still
+     signal it while get goes on to destroy the frame.
+     */
+    struct Waiter
+    {
+        mutex lock;
+
+        condition_variable finished;
+
+        bool done = false;
+    };
+
+    struct promise_type;
+
+    /*
+     FinalAwaiter: on finishing, hands the thread to the coroutine
+     awaiting the task, or wakes get.
+     */
+    struct FinalAwaiter
+    {
+        bool await_ready() const noexcept;
+
+        coroutine_handle<> await_suspend(coroutine_handle<promise_type> finishing) const noexcept;
+
+        void await_resume() const noexcept;
+    };
+
+    /*
+     promise_type: the state the compiler keeps in the coroutine frame.
+     */
+    struct promise_type
+    {
+        optional<T> value;                        // set by co_return
+
+        exception_ptr error;                      // set if the coroutine threw
+
+        coroutine_handle<> continuation;          // coroutine awaiting the task, if any
+
+        shared_ptr<Waiter> waiter;                // set by get
+
+        QueryTask get_return_object();
+
+        suspend_always initial_suspend() const noexcept;
+
+        FinalAwaiter final_suspend() const noexcept;
+
+        void return_value(T result);
+
+        void unhandled_exception();
+    };
+
+    /*
+     Move constructor:
+     Pre-condition: other is a task.
+     Post-condition: The coroutine of other belongs to this task and other is empty.
+     */
+    QueryTask(QueryTask&& other) noexcept;
+
+    /*
+     ~QueryTask:
+     Pre-condition: The coroutine has not started or has finished.
+     Post-condition: The coroutine frame is deallocated.
+     */
+    ~QueryTask();
+
+    /*
+     await_ready, await_suspend, await_resume:
+     Pre-condition: The task is awaited once, from a coroutine.
+     Post-condition: The coroutine of the task runs, and the awaiting coroutine is resumed with its result once it finishes.
+     */
+    bool await_ready() const noexcept;
+
+    coroutine_handle<> await_suspend(coroutine_handle<> awaiting) noexcept;
+
+    T await_resume();
+
+    /*
+     get:
+     Pre-condition: The task has not been started.
+     Post-condition: The coroutine is run and its result is returned once it finishes. The calling thread blocks in the meantime.
+     */
+    T get();
+
+private:
+    explicit QueryTask(coroutine_handle<promise_type> handle);
+
+    QueryTask(const QueryTask&);                  // a coroutine has one owner
+    QueryTask& operator=(const QueryTask&);
+
+    /*
+     result:
+     Pre-condition: The coroutine has finished.
+     Post-condition: Its exception is thrown again, or else its value is returned.
+     */
+    T result();
+
+    coroutine_handle<promise_type> handle;
+};
+
+template <typename T>
+bool QueryTask<T>::FinalAwaiter::await_ready() const noexcept
+{
+    return false;
+}
+
+template <typename T>
+coroutine_handle<> QueryTask<T>::FinalAwaiter::await_suspend(coroutine_handle<promise_type> finishing) const noexcept
+{
+    promise_type& promise = finishing.promise();
+    if(promise.continuation)
+    {
+        return promise.continuation;
+    }
+
+    // a copy on the stack, as the frame may be destroyed as soon as done is seen
+    shared_ptr<Waiter> waiter = promise.waiter;
+    if(waiter)
+    {
+        lock_guard<mutex> guard(waiter->lock);
+        waiter->done = true;
+        waiter->finished.notify_all();
+    }
+    return noop_coroutine();
+}
+
+template <typename T>
+void QueryTask<T>::FinalAwaiter::await_resume() const noexcept
+{
+}
+
+template <typename T>
+QueryTask<T> QueryTask<T>::promise_type::get_return_object()
+{
+    return QueryTask(coroutine_handle<promise_type>::from_promise(*this));
+}
+
+template <typename T>
+suspend_always QueryTask<T>::promise_type::initial_suspend() const noexcept
+{
+    return suspend_always();
+}
+
+template <typename T>
+typename QueryTask<T>::FinalAwaiter QueryTask<T>::promise_type::final_suspend() const noexcept
+{
+    return FinalAwaiter();
+}
+
+template <typename T>
+void QueryTask<T>::promise_type::return_value(T result)
+{
+    value = std::move(result);
+}
+
+template <typename T>
+void QueryTask<T>::promise_type::unhandled_exception()
+{
+    error = current_exception();
+}
+
+/*
+ Constructor:
+ Pre-condition: handle is a coroutine suspended at its start.
+ Post-condition: The task owns the coroutine.
+ */
+template <typename T>
+QueryTask<T>::QueryTask(coroutine_handle<promise_type> handle) : handle(handle)
+{
+}
+
+/*
+ Move constructor:
+ Pre-condition: other is a task.
+ Post-condition: The coroutine of other belongs to this task and other is empty.
+ */
+template <typename T>
+QueryTask<T>::QueryTask(QueryTask&& other) noexcept : handle(other.handle)
+{
+    other.handle = nullptr;
+}
+
+/*
+ ~QueryTask:
+ Pre-condition: The coroutine has not started or has finished.
+ Post-condition: The coroutine frame is deallocated.
+ */
+template <typename T>
+QueryTask<T>::~QueryTask()
+{
+    if(handle)
+    {
+        handle.destroy();
+    }
+}
+
+/*
+ await_ready, await_suspend, await_resume:
+ Pre-condition: The task is awaited once, from a coroutine.
+ Post-condition: The coroutine of the task runs, and the awaiting coroutine is resumed with its result once it finishes.
+ */
+template <typename T>
+bool QueryTask<T>::await_ready() const noexcept
+{
+    return false;
+}
+
+template <typename T>
+coroutine_handle<> QueryTask<T>::await_suspend(coroutine_handle<> awaiting) noexcept
+{
+    handle.promise().continuation = awaiting;
+    return handle;
+}
+
+template <typename T>
+T QueryTask<T>::await_resume()
+{
+    return result();
+}
+
+/*
+ get:
+ Pre-condition: The task has not been started.
+ Post-condition: The coroutine is run and its result is returned once it finishes. The calling thread blocks in the meantime.
+ */
+template <typename T>
+T QueryTask<T>::get()
+{
+    shared_ptr<Waiter> waiter = make_shared<Waiter>();
+    handle.promise().waiter = waiter;
+    handle.resume();
+
+    unique_lock<mutex> guard(waiter->lock);
+    waiter->finished.wait(guard, [&waiter] { return waiter->done; });
+    return result();
+}
+
+/*
+ result:
+ Pre-condition: The coroutine has finished.
+ Post-condition: Its exception is thrown again, or else its value is returned.
+ */
+template <typename T>
+T QueryTask<T>::result()
+{
+    if(handle.promise().error)
+    {
+        rethrow_exception(handle.promise().error);
+    }
+    return std::move(*handle.promise().value);
+}
+
+#endif
@@ -0,0 +1,133 @@
+/*****************************************************************/
+/* ReportWriter.cpp
+/*
+/* Author: Hans Nicolaus
+/*
+/* This file contains the implementations of the constructors and
+/* methods which interfaces are defined in the ReportWriter.h file
+/*
+/*****************************************************************/
+
+#include "reportwriter.h"
+#include <charconv>
+#include <cstring>
+
+/*
+ Constructor:
+ Pre-condition: output is the stream that will receive the report.
+                format is the layout of the report.
+                capacity is the expected size of the report, up to BUFFERSIZE.
+ Post-condition: An empty buffer of capacity bytes is reserved for the report. It grows if the report is longer, up to BUFFERSIZE.
+ */
+ReportWriter::ReportWriter(ostream& output, Format format, size_t capacity) : output(output), format(format)
+{
+    if(capacity > BUFFERSIZE)
+    {
+        capacity = BUFFERSIZE;
+    }
+    buffer.reserve(capacity);
+}
+
+/*
+ ~ReportWriter:
+ Pre-condition: The ReportWriter is going out of scope.
+ Post-condition: Anything still buffered is written to the output stream.
+ */
+ReportWriter::~ReportWriter()
+{
+    flush();
+}
+
+/*
+ getFormat:
+ Pre-condition: None.
+ Post-condition: The layout of the report is returned.
+ */
+ReportWriter::Format ReportWriter::getFormat() const
+{
+    return format;
+}
+
+/*
+ writeBinary:
+ Pre-condition: value is the integer to be written.
+ Post-condition: value is appended to the buffer as a native 32-bit integer.
+ */
+void ReportWriter::writeBinary(int value)
+{
+    reserveFor(sizeof(value));
+    char bytes[sizeof(value)];
+    memcpy(bytes, &value, sizeof(value));
+    buffer.append(bytes, sizeof(value));
+}
+
+/*
+ flush:
+ Pre-condition: None.
+ Post-condition: The buffer is written to the output stream with a single write call and emptied. The output stream itself is not flushed.
+ */
+void ReportWriter::flush()
+{
+    if(!buffer.empty())
+    {
+        output.write(buffer.data(), buffer.size());
+        buffer.clear();
+    }
+}
+
+/*
+ reserveFor:
+ Pre-condition: length is the number of bytes about to be appended.
+ Post-condition: The buffer is written out first if length bytes would make it grow past BUFFERSIZE.
+ */
+void ReportWriter::reserveFor(size_t length)
+{
+    if(buffer.size() + length > BUFFERSIZE)
+    {
+        flush();
+    }
+}
+
+/*
+ operator<<:
+ Pre-condition: The value to be appended is valid.
+ Post-condition: The value is appended to the buffer as text. The buffer is written out once it grows past BUFFERSIZE.
+ */
+ReportWriter& ReportWriter::operator<<(const string& str)
+{
+    reserveFor(str.size());
+    buffer.append(str);
+    return *this;
+}
+
+ReportWriter& ReportWriter::operator<<(string_view str)
+{
+    reserveFor(str.size());
+    buffer.append(str);
+    return *this;
+}
+
+ReportWriter& ReportWriter::operator<<(const char* str)
+{
+    size_t length = strlen(str);
+    reserveFor(length);
+    buffer.append(str, length);
+    return *this;
+}
+
+ReportWriter& ReportWriter::operator<<(char c)
+{
+    reserveFor(1);
+    buffer.push_back(c);
+    return *this;
+}
+
+ReportWriter& ReportWriter::operator<<(int value)
+{
+    // formatting into a stack array, so no temporary string is allocated
+    char digits[16];
+    char* end = to_chars(digits, digits + sizeof(digits), value).ptr;
+    reserveFor(end - digits);
+    buffer.append(digits, end - digits);
+    return *this;
+}
@@ -0,0 +1,98 @@
+/*****************************************************************/
+/* ReportWriter.h
+/*
+/* Author: Hans Nicolaus
+/*
+/* This header file contains the interfaces of method implementations
+/* of the ReportWriter class, which hides the implementations
+/* of all methods that are implemented in the ReportWriter.cpp file.
+/*
+/* A ReportWriter formats text into one reusable buffer and hands it
+/* to the output stream in large blocks, so printing a table does not
+/* flush the stream after every line.
+/*
+/*****************************************************************/
+
+#ifndef REPORTWRITER_H
+#define REPORTWRITER_H
+#include <string>
+#include <string_view>
+#include <iostream>
+using namespace std;
+
+class ReportWriter
+{
+public:
+    /*
+     Format: the layout used by GraphM and GraphL when writing reports.
+     TEXT is the original console table, CSV and JSONL write one record
+     per line, BINARY writes native 32-bit integers.
+     */
+    enum Format { TEXT, CSV, JSONL, BINARY };
+
+    const static size_t BUFFERSIZE = 65536;   // bytes kept before writing out
+
+    /*
+     Constructor:
+     Pre-condition: output is the stream that will receive the report.
+                    format is the layout of the report.
+                    capacity is the expected size of the report, up to BUFFERSIZE.
+     Post-condition: An empty buffer of capacity bytes is reserved for the report. It grows if the report is longer, up to BUFFERSIZE.
+     */
+    ReportWriter(ostream& output, Format format = TEXT, size_t capacity = BUFFERSIZE);
+
+    /*
+     ~ReportWriter:
+     Pre-condition: The ReportWriter is going out of scope.
+     Post-condition: Anything still buffered is written to the output stream.
+     */
+    ~ReportWriter();
+
+    /*
+     getFormat:
+     Pre-condition: None.
+     Post-condition: The layout of the report is returned.
+     */
+    Format getFormat() const;
+
+    /*
+     writeBinary:
+     Pre-condition: value is the integer to be written.
+     Post-condition: value is appended to the buffer as a native 32-bit integer.
+     */
+    void writeBinary(int value);
+
+    /*
+     flush:
+     Pre-condition: None.
+     Post-condition: The buffer is written to the output stream with a single write call and emptied. The output stream itself is not flushed.
+     */
+    void flush();
+
+    /*
+     operator<<:
+     Pre-condition: The value to be appended is valid.
+     Post-condition: The value is appended to the buffer as text. The buffer is written out once it grows past BUFFERSIZE.
+     */
+    ReportWriter& operator<<(const string& str);
+    ReportWriter& operator<<(string_view str);
+    ReportWriter& operator<<(const char* str);
+    ReportWriter& operator<<(char c);
+    ReportWriter& operator<<(int value);
+
+private:
+    /*
+     reserveFor:
+     Pre-condition: length is the number of bytes about to be appended.
+     Post-condition: The buffer is written out first if length bytes would make it grow past BUFFERSIZE.
+     */
+    void reserveFor(size_t length);
+
+    ostream& output;                          // stream receiving the report
+
+    Format format;                            // layout of the report
+
+    string buffer;                            // formatted but unwritten text
+};
+
+#endif
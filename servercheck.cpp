@@ -0,0 +1,282 @@
+/*****************************************************************/
+/* servercheck.cpp
+/*
+/* Author: Hans Nicolaus
+/*
+/* This driver file is a client of graphserver. It builds the first
+/* graph of each data file itself, sends POINT, SOURCE and DFS requests
+/* for every vertex and a set of invalid requests, and checks every
+/* response against its own graphs. The SOURCE requests are also sent
+/* at once without waiting, so several of them are answered in one
+/* wakeup of the server. One line is printed per check.
+/*
+/* Usage: servercheck <socket path> <GraphM data file> <GraphL data file>
+/* The server has to be started on the same socket and files first:
+/*   graphserver /tmp/graph.sock data31.txt data32.txt &
+/*   servercheck /tmp/graph.sock data31.txt data32.txt
+/* The exit status is the number of failed checks.
+/*
+/*****************************************************************/
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "graphm.h"
+#include "graphl.h"
+using namespace std;
+
+const int OP_POINT = 1;           // point-to-point shortest path
+const int OP_SOURCE = 2;          // single-source shortest distances
+const int OP_DFS = 3;             // depth-first ordering
+const int OP_UNKNOWN = 9;         // no such operation
+
+const int CONNECTTRIES = 50;      // the server may still be loading its graphs
+const int CONNECTWAIT = 100000;   // microseconds between tries
+
+int failures = 0;                 // checks that did not pass
+
+/*
+ check:
+ Pre-condition: what names the check.
+ Post-condition: The outcome is printed, and counted if the check failed.
+ */
+void check(const string& what, bool passed)
+{
+    cout << what << (passed ? " passed" : " FAILED") << endl;
+    if(!passed)
+    {
+        failures++;
+    }
+}
+
+/*
+ writeFully:
+ Pre-condition: fd is a connected socket.
+ Post-condition: Returns true if all bytes of buffer were sent.
+ */
+bool writeFully(int fd, const void* buffer, size_t bytes)
+{
+    const char* next = static_cast<const char*>(buffer);
+    while(bytes > 0)
+    {
+        ssize_t n = write(fd, next, bytes);
+        if(n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if(n <= 0)
+        {
+            return false;
+        }
+        next += n;
+        bytes -= n;
+    }
+    return true;
+}
+
+/*
+ readFully:
+ Pre-condition: fd is a connected socket.
+ Post-condition: Returns true if buffer was filled before the server hung up.
+ */
+bool readFully(int fd, void* buffer, size_t bytes)
+{
+    char* next = static_cast<char*>(buffer);
+    while(bytes > 0)
+    {
+        ssize_t n = read(fd, next, bytes);
+        if(n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if(n <= 0)
+        {
+            return false;
+        }
+        next += n;
+        bytes -= n;
+    }
+    return true;
+}
+
+/*
+ sendRequest:
+ Pre-condition: fd is a connected socket.
+                op, a and b are the fields of one request.
+ Post-condition: Returns true if the request was sent.
+ */
+bool sendRequest(int fd, int op, int a, int b)
+{
+    int request[3] = {op, a, b};
+    return writeFully(fd, request, sizeof(request));
+}
+
+/*
+ readResponse:
+ Pre-condition: fd is a connected socket with a request sent.
+                values is where the integers of the response are written.
+ Post-condition: Returns true if a whole response to op was read. count is -1 for an invalid request.
+ */
+bool readResponse(int fd, int op, int& count, vector<int>& values)
+{
+    int header[2];
+    if(!readFully(fd, header, sizeof(header)) || header[0] != op)
+    {
+        return false;
+    }
+    count = header[1];
+    values.assign(count > 0 ? count : 0, 0);
+    return values.empty() || readFully(fd, values.data(), values.size() * sizeof(int));
+}
+
+/*
+ ask:
+ Pre-condition: fd is a connected socket with no response outstanding.
+ Post-condition: Returns true if the request was answered. count and values hold the response.
+ */
+bool ask(int fd, int op, int a, int b, int& count, vector<int>& values)
+{
+    return sendRequest(fd, op, a, b) && readResponse(fd, op, count, values);
+}
+
+/*
+ expectedPoint:
+ Pre-condition: G is solved. source and dest are vertices of G.
+ Post-condition: values holds the POINT response for source and dest: the distance and the path, or nothing if dest is unreachable.
+ */
+void expectedPoint(const GraphM& G, int source, int dest, vector<int>& values)
+{
+    values.clear();
+    for(GraphM::PathIterator it = G.pathBegin(source, dest); it != G.pathEnd(); ++it)
+    {
+        values.insert(values.begin(), *it);
+    }
+    if(!values.empty())
+    {
+        values.insert(values.begin(), G.getDistance(source, dest));
+    }
+}
+
+/*
+ connectTo:
+ Pre-condition: path names a Unix domain socket.
+ Post-condition: The connected socket is returned, or -1 if the server could not be reached.
+ */
+int connectTo(const char* path)
+{
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, path, sizeof(address.sun_path) - 1);
+
+    for(int tries = 0; tries < CONNECTTRIES; tries++)
+    {
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if(fd < 0)
+        {
+            return -1;
+        }
+        if(connect(fd, (sockaddr*)&address, sizeof(address)) == 0)
+        {
+            return fd;
+        }
+        close(fd);
+        usleep(CONNECTWAIT);
+    }
+    return -1;
+}
+
+int main(int argc, char* argv[])
+{
+    if(argc < 4)
+    {
+        cout << "Usage: servercheck <socket path> <GraphM data file> <GraphL data file>" << endl;
+        return 1;
+    }
+
+    ifstream infile1(argv[2]);
+    ifstream infile2(argv[3]);
+    if(!infile1 || !infile2)
+    {
+        cout << "File could not be opened." << endl;
+        return 1;
+    }
+    GraphM G;
+    G.buildGraph(infile1);
+    G.findShortestPath();
+    GraphL L;
+    L.buildGraph(infile2);
+
+    int fd = connectTo(argv[1]);
+    if(fd < 0)
+    {
+        cout << "Server could not be reached: " << strerror(errno) << endl;
+        return 1;
+    }
+
+    int n = G.getSize();
+    int count;
+    vector<int> values;
+    vector<int> expected;
+
+    // POINT: every ordered pair, the unreachable ones included
+    bool same = true;
+    for(int source = 1; source <= n && same; source++)
+    {
+        for(int dest = 1; dest <= n && same; dest++)
+        {
+            expectedPoint(G, source, dest, expected);
+            same = ask(fd, OP_POINT, source, dest, count, values) && count == (int)expected.size() && values == expected;
+        }
+    }
+    check("POINT", same);
+
+    // SOURCE: all requests go out before the first response is read
+    same = true;
+    for(int source = 1; source <= n && same; source++)
+    {
+        same = sendRequest(fd, OP_SOURCE, source, 0);
+    }
+    for(int source = 1; source <= n && same; source++)
+    {
+        same = readResponse(fd, OP_SOURCE, count, values) && count == n;
+        for(int dest = 1; dest <= n && same; dest++)
+        {
+            same = values[dest - 1] == G.getDistance(source, dest);
+        }
+    }
+    check("SOURCE", same);
+
+    // DFS: the whole graph, then from every vertex
+    same = true;
+    for(int start = 0; start <= L.getSize() && same; start++)
+    {
+        L.depthFirstOrder(start, expected);
+        same = ask(fd, OP_DFS, start, 0, count, values) && count == (int)expected.size() && values == expected;
+    }
+    check("DFS", same);
+
+    // every invalid request is answered with a count of -1 and the connection stays usable
+    int invalid[][3] = {
+        {OP_POINT, 0, 1}, {OP_POINT, 1, n + 1}, {OP_SOURCE, -1, 0}, {OP_SOURCE, n + 1, 0},
+        {OP_DFS, -1, 0}, {OP_DFS, L.getSize() + 1, 0}, {OP_UNKNOWN, 1, 1}
+    };
+    same = true;
+    for(int i = 0; i < (int)(sizeof(invalid) / sizeof(invalid[0])) && same; i++)
+    {
+        same = ask(fd, invalid[i][0], invalid[i][1], invalid[i][2], count, values) && count == -1;
+    }
+    expectedPoint(G, 1, n, expected);
+    same = same && ask(fd, OP_POINT, 1, n, count, values) && values == expected;
+    check("Invalid requests", same);
+
+    close(fd);
+    cout << (failures == 0 ? "All checks passed." : "Some checks FAILED.") << endl;
+    return failures;
+}
@@ -0,0 +1,176 @@
+/*****************************************************************/
+/* VertexOrder.cpp
+/*
+/* Author: Hans Nicolaus
+/*
+/* This file contains the implementations of the constructors and
+/* methods which interfaces are defined in the VertexOrder.h file
+/*
+/*****************************************************************/
+
+#include "vertexorder.h"
+#include <algorithm>
+
+/*
+ Default constructor:
+ Pre-condition: None.
+ Post-condition: The mapping is the identity for every vertex.
+ */
+VertexOrder::VertexOrder()
+{
+}
+
+/*
+ reset:
+ Pre-condition: size is the number of vertices in the graph.
+ Post-condition: The mapping is the identity for vertices 1 to size.
+ */
+void VertexOrder::reset(int size)
+{
+    internalOf.resize(size + 1);
+    externalOf.resize(size + 1);
+
+    for(int v = 0; v <= size; v++)
+    {
+        internalOf[v] = v;
+        externalOf[v] = v;
+    }
+}
+
+/*
+ computeOrder:
+ Pre-condition: neighbours[v] lists the vertices adjacent to v in either direction, for v from 1 to size.
+                ordering is the renumbering strategy.
+ Post-condition: newToOld[n] is the current number of the vertex that becomes number n, for n from 1 to size.
+ */
+void VertexOrder::computeOrder(int size, const vector< vector<int> >& neighbours, Ordering ordering, vector<int>& newToOld)
+{
+    newToOld.assign(1, 0);
+
+    if(ordering == IDENTITY || ordering == DEGREE)
+    {
+        for(int v = 1; v <= size; v++)
+        {
+            newToOld.push_back(v);
+        }
+
+        if(ordering == DEGREE)
+        {
+            // hubs first, ties keep their input order
+            stable_sort(newToOld.begin() + 1, newToOld.end(), [&neighbours](int a, int b)
+            {
+                return neighbours[a].size() > neighbours[b].size();
+            });
+        }
+        return;
+    }
+
+    vector<bool> visited(size + 1, false);
+    vector<int> next;                     // neighbours of the vertex being expanded
+
+    for(;;)
+    {
+        // BFS starts each component at its lowest number, RCM at its lowest degree
+        int start = 0;
+        for(int v = 1; v <= size; v++)
+        {
+            if(!visited[v] && (start == 0 || (ordering == RCM && neighbours[v].size() < neighbours[start].size())))
+            {
+                start = v;
+            }
+        }
+
+        if(start == 0)
+        {
+            break;
+        }
+
+        // newToOld doubles as the breadth-first queue
+        int head = newToOld.size();
+        newToOld.push_back(start);
+        visited[start] = true;
+
+        while(head < (int)newToOld.size())
+        {
+            int v = newToOld[head];
+            head++;
+
+            next.clear();
+            for(int i = 0; i < (int)neighbours[v].size(); i++)
+            {
+                if(!visited[neighbours[v][i]])
+                {
+                    next.push_back(neighbours[v][i]);
+                    visited[neighbours[v][i]] = true;
+                }
+            }
+
+            if(ordering == RCM)
+            {
+                stable_sort(next.begin(), next.end(), [&neighbours](int a, int b)
+                {
+                    return neighbours[a].size() < neighbours[b].size();
+                });
+            }
+            else
+            {
+                sort(next.begin(), next.end());
+            }
+            newToOld.insert(newToOld.end(), next.begin(), next.end());
+        }
+    }
+
+    if(ordering == RCM)
+    {
+        reverse(newToOld.begin() + 1, newToOld.end());
+    }
+}
+
+/*
+ permute:
+ Pre-condition: newToOld is a permutation of 1 to size as returned by computeOrder.
+ Post-condition: Every internal number is renumbered by newToOld, and external numbers keep referring to the same vertices.
+ */
+void VertexOrder::permute(const vector<int>& newToOld)
+{
+    int size = newToOld.size() - 1;
+    if((int)externalOf.size() != size + 1)
+    {
+        reset(size);
+    }
+
+    vector<int> oldExternal(externalOf);
+    for(int n = 1; n <= size; n++)
+    {
+        externalOf[n] = oldExternal[newToOld[n]];
+        internalOf[externalOf[n]] = n;
+    }
+}
+
+/*
+ toInternal:
+ Pre-condition: external is a vertex number from the input file.
+ Post-condition: The internal number of that vertex is returned. Numbers outside the graph are returned unchanged.
+ */
+int VertexOrder::toInternal(int external) const
+{
+    if(external < 1 || external >= (int)internalOf.size())
+    {
+        return external;
+    }
+    return internalOf[external];
+}
+
+/*
+ toExternal:
+ Pre-condition: internal is a vertex number used inside the graph.
+ Post-condition: The number of that vertex in the input file is returned. Numbers outside the graph are returned unchanged.
+ */
+int VertexOrder::toExternal(int internal) const
+{
+    if(internal < 1 || internal >= (int)externalOf.size())
+    {
+        return internal;
+    }
+    return externalOf[internal];
+}
@@ -0,0 +1,81 @@
+/*****************************************************************/
+/* VertexOrder.h
+/*
+/* Author: Hans Nicolaus
+/*
+/* This header file contains the interfaces of method implementations
+/* of the VertexOrder class, which hides the implementations
+/* of all methods that are implemented in the VertexOrder.cpp file.
+/*
+/* A VertexOrder maps the vertex numbers read from the input file
+/* (external) to the numbers a graph stores its vertices under
+/* (internal), so a graph can renumber its vertices for locality
+/* while callers keep using the numbers from the file.
+/*
+/*****************************************************************/
+
+#ifndef VERTEXORDER_H
+#define VERTEXORDER_H
+#include <vector>
+using namespace std;
+
+class VertexOrder
+{
+public:
+    /*
+     Ordering: the renumbering strategies. IDENTITY keeps the input order,
+     RCM is reverse Cuthill-McKee, BFS numbers vertices in breadth-first
+     order and DEGREE puts the vertices with the most edges first.
+     */
+    enum Ordering { IDENTITY, RCM, BFS, DEGREE };
+
+    /*
+     Default constructor:
+     Pre-condition: None.
+     Post-condition: The mapping is the identity for every vertex.
+     */
+    VertexOrder();
+
+    /*
+     reset:
+     Pre-condition: size is the number of vertices in the graph.
+     Post-condition: The mapping is the identity for vertices 1 to size.
+     */
+    void reset(int size);
+
+    /*
+     computeOrder:
+     Pre-condition: neighbours[v] lists the vertices adjacent to v in either direction, for v from 1 to size.
+                    ordering is the renumbering strategy.
+     Post-condition: newToOld[n] is the current number of the vertex that becomes number n, for n from 1 to size.
+     */
+    static void computeOrder(int size, const vector< vector<int> >& neighbours, Ordering ordering, vector<int>& newToOld);
+
+    /*
+     permute:
+     Pre-condition: newToOld is a permutation of 1 to size as returned by computeOrder.
+     Post-condition: Every internal number is renumbered by newToOld, and external numbers keep referring to the same vertices.
+     */
+    void permute(const vector<int>& newToOld);
+
+    /*
+     toInternal:
+     Pre-condition: external is a vertex number from the input file.
+     Post-condition: The internal number of that vertex is returned. Numbers outside the graph are returned unchanged.
+     */
+    int toInternal(int external) const;
+
+    /*
+     toExternal:
+     Pre-condition: internal is a vertex number used inside the graph.
+     Post-condition: The number of that vertex in the input file is returned. Numbers outside the graph are returned unchanged.
+     */
+    int toExternal(int internal) const;
+
+private:
+    vector<int> internalOf;    // internal number of each external vertex
+
+    vector<int> externalOf;    // external number of each internal vertex
+};
+
+#endif